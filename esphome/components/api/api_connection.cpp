@@ -26,7 +26,7 @@ APIConnection::APIConnection(AsyncClient *client, APIServer *parent)
                         this);
 
   this->send_buffer_.reserve(64);
-  this->recv_buffer_.reserve(32);
+  this->recv_buffer_.resize(128);
   this->client_info_ = this->client_->remoteIP().toString().c_str();
   this->last_traffic_ = millis();
 }
@@ -37,29 +37,45 @@ void APIConnection::on_timeout_(uint32_t time) { this->on_fatal_error(); }
 void APIConnection::on_data_(uint8_t *buf, size_t len) {
   if (len == 0 || buf == nullptr)
     return;
-  this->recv_buffer_.insert(this->recv_buffer_.end(), buf, buf + len);
+  if (this->recv_buffer_.size() - this->recv_end_ < len) {
+    // Not enough space at the end, move the unparsed data to the front first.
+    const size_t pending = this->recv_end_ - this->recv_start_;
+    if (pending != 0 && this->recv_start_ != 0)
+      memmove(this->recv_buffer_.data(), this->recv_buffer_.data() + this->recv_start_, pending);
+    this->recv_start_ = 0;
+    this->recv_end_ = pending;
+    // only grow if a single message doesn't fit in the buffer
+    if (this->recv_buffer_.size() - this->recv_end_ < len)
+      this->recv_buffer_.resize(this->recv_end_ + len);
+  }
+  memcpy(this->recv_buffer_.data() + this->recv_end_, buf, len);
+  this->recv_end_ += len;
+  // don't wait for the rest of the loop interval to parse the message
+  this->parent_->wakeup();
 }
 void APIConnection::parse_recv_buffer_() {
-  if (this->recv_buffer_.empty() || this->remove_)
+  if (this->recv_start_ == this->recv_end_ || this->remove_)
     return;
 
-  while (!this->recv_buffer_.empty()) {
-    if (this->recv_buffer_[0] != 0x00) {
+  while (this->recv_start_ < this->recv_end_) {
+    // messages are decoded in place, consumed bytes are skipped by advancing recv_start_
+    uint8_t *data = this->recv_buffer_.data() + this->recv_start_;
+    const uint32_t size = this->recv_end_ - this->recv_start_;
+    if (data[0] != 0x00) {
       ESP_LOGW(TAG, "Invalid preamble from %s", this->client_info_.c_str());
       this->on_fatal_error();
       return;
     }
     uint32_t i = 1;
-    const uint32_t size = this->recv_buffer_.size();
     uint32_t consumed;
-    auto msg_size_varint = ProtoVarInt::parse(&this->recv_buffer_[i], size - i, &consumed);
+    auto msg_size_varint = ProtoVarInt::parse(&data[i], size - i, &consumed);
     if (!msg_size_varint.has_value())
       // not enough data there yet
       return;
     i += consumed;
     uint32_t msg_size = msg_size_varint->as_uint32();
 
-    auto msg_type_varint = ProtoVarInt::parse(&this->recv_buffer_[i], size - i, &consumed);
+    auto msg_type_varint = ProtoVarInt::parse(&data[i], size - i, &consumed);
     if (!msg_type_varint.has_value())
       // not enough data there yet
       return;
@@ -70,15 +86,17 @@ void APIConnection::parse_recv_buffer_() {
       // message body not fully received
       return;
 
-    uint8_t *msg = &this->recv_buffer_[i];
+    uint8_t *msg = &data[i];
     this->read_message(msg_size, msg_type, msg);
     if (this->remove_)
       return;
-    // pop front
-    uint32_t total = i + msg_size;
-    this->recv_buffer_.erase(this->recv_buffer_.begin(), this->recv_buffer_.begin() + total);
+    this->recv_start_ += i + msg_size;
     this->last_traffic_ = millis();
   }
+
+  // everything parsed, start writing at the front again
+  this->recv_start_ = 0;
+  this->recv_end_ = 0;
 }
 
 void APIConnection::disconnect_client() {
@@ -108,6 +126,7 @@ void APIConnection::loop() {
   }
   this->parse_recv_buffer_();
 
+  this->process_deferred_states_();
   this->list_entities_iterator_.advance();
   this->initial_state_iterator_.advance();
 
@@ -129,7 +148,7 @@ void APIConnection::loop() {
     // reserve 15 bytes for metadata, and at least 64 bytes of data
     if (space >= 15 + 64) {
       uint32_t to_send = std::min(space - 15, this->image_reader_.available());
-      auto buffer = this->create_buffer();
+      auto buffer = this->create_buffer(15 + to_send);
       // fixed32 key = 1;
       buffer.encode_fixed32(1, esp32_camera::global_esp32_camera->get_object_id_hash());
       // bytes data = 2;
@@ -148,6 +167,14 @@ void APIConnection::loop() {
     }
   }
 #endif
+
+  this->flush_();
+}
+void APIConnection::flush_() {
+  if (!this->send_pending_)
+    return;
+  this->send_pending_ = false;
+  this->client_->send();
 }
 
 std::string get_default_unique_id(const std::string &component_type, Nameable *nameable) {
@@ -158,12 +185,15 @@ std::string get_default_unique_id(const std::string &component_type, Nameable *n
 bool APIConnection::send_binary_sensor_state(binary_sensor::BinarySensor *binary_sensor, bool state) {
   if (!this->state_subscription_)
     return false;
+  if (this->is_state_deferred_(binary_sensor))
+    return true;
 
   BinarySensorStateResponse resp;
   resp.key = binary_sensor->get_object_id_hash();
   resp.state = state;
   resp.missing_state = !binary_sensor->has_state();
-  return this->send_binary_sensor_state_response(resp);
+  return this->send_state_or_defer_(this->send_binary_sensor_state_response(resp), DeferredStateType::BINARY_SENSOR,
+                                    binary_sensor);
 }
 bool APIConnection::send_binary_sensor_info(binary_sensor::BinarySensor *binary_sensor) {
   ListEntitiesBinarySensorResponse msg;
@@ -181,6 +211,8 @@ bool APIConnection::send_binary_sensor_info(binary_sensor::BinarySensor *binary_
 bool APIConnection::send_cover_state(cover::Cover *cover) {
   if (!this->state_subscription_)
     return false;
+  if (this->is_state_deferred_(cover))
+    return true;
 
   auto traits = cover->get_traits();
   CoverStateResponse resp{};
@@ -191,7 +223,7 @@ bool APIConnection::send_cover_state(cover::Cover *cover) {
   if (traits.get_supports_tilt())
     resp.tilt = cover->tilt;
   resp.current_operation = static_cast<enums::CoverOperation>(cover->current_operation);
-  return this->send_cover_state_response(resp);
+  return this->send_state_or_defer_(this->send_cover_state_response(resp), DeferredStateType::COVER, cover);
 }
 bool APIConnection::send_cover_info(cover::Cover *cover) {
   auto traits = cover->get_traits();
@@ -239,6 +271,8 @@ void APIConnection::cover_command(const CoverCommandRequest &msg) {
 bool APIConnection::send_fan_state(fan::FanState *fan) {
   if (!this->state_subscription_)
     return false;
+  if (this->is_state_deferred_(fan))
+    return true;
 
   auto traits = fan->get_traits();
   FanStateResponse resp{};
@@ -250,7 +284,7 @@ bool APIConnection::send_fan_state(fan::FanState *fan) {
     resp.speed = static_cast<enums::FanSpeed>(fan->speed);
   if (traits.supports_direction())
     resp.direction = static_cast<enums::FanDirection>(fan->direction);
-  return this->send_fan_state_response(resp);
+  return this->send_state_or_defer_(this->send_fan_state_response(resp), DeferredStateType::FAN, fan);
 }
 bool APIConnection::send_fan_info(fan::FanState *fan) {
   auto traits = fan->get_traits();
@@ -286,6 +320,8 @@ void APIConnection::fan_command(const FanCommandRequest &msg) {
 bool APIConnection::send_light_state(light::LightState *light) {
   if (!this->state_subscription_)
     return false;
+  if (this->is_state_deferred_(light))
+    return true;
 
   auto traits = light->get_traits();
   auto values = light->remote_values;
@@ -306,7 +342,7 @@ bool APIConnection::send_light_state(light::LightState *light) {
     resp.color_temperature = values.get_color_temperature();
   if (light->supports_effects())
     resp.effect = light->get_effect_name();
-  return this->send_light_state_response(resp);
+  return this->send_state_or_defer_(this->send_light_state_response(resp), DeferredStateType::LIGHT, light);
 }
 bool APIConnection::send_light_info(light::LightState *light) {
   auto traits = light->get_traits();
@@ -363,12 +399,14 @@ void APIConnection::light_command(const LightCommandRequest &msg) {
 bool APIConnection::send_sensor_state(sensor::Sensor *sensor, float state) {
   if (!this->state_subscription_)
     return false;
+  if (this->is_state_deferred_(sensor))
+    return true;
 
   SensorStateResponse resp{};
   resp.key = sensor->get_object_id_hash();
   resp.state = state;
   resp.missing_state = !sensor->has_state();
-  return this->send_sensor_state_response(resp);
+  return this->send_state_or_defer_(this->send_sensor_state_response(resp), DeferredStateType::SENSOR, sensor);
 }
 bool APIConnection::send_sensor_info(sensor::Sensor *sensor) {
   ListEntitiesSensorResponse msg;
@@ -390,11 +428,13 @@ bool APIConnection::send_sensor_info(sensor::Sensor *sensor) {
 bool APIConnection::send_switch_state(switch_::Switch *a_switch, bool state) {
   if (!this->state_subscription_)
     return false;
+  if (this->is_state_deferred_(a_switch))
+    return true;
 
   SwitchStateResponse resp{};
   resp.key = a_switch->get_object_id_hash();
   resp.state = state;
-  return this->send_switch_state_response(resp);
+  return this->send_state_or_defer_(this->send_switch_state_response(resp), DeferredStateType::SWITCH, a_switch);
 }
 bool APIConnection::send_switch_info(switch_::Switch *a_switch) {
   ListEntitiesSwitchResponse msg;
@@ -422,12 +462,15 @@ void APIConnection::switch_command(const SwitchCommandRequest &msg) {
 bool APIConnection::send_text_sensor_state(text_sensor::TextSensor *text_sensor, std::string state) {
   if (!this->state_subscription_)
     return false;
+  if (this->is_state_deferred_(text_sensor))
+    return true;
 
   TextSensorStateResponse resp{};
   resp.key = text_sensor->get_object_id_hash();
   resp.state = std::move(state);
   resp.missing_state = !text_sensor->has_state();
-  return this->send_text_sensor_state_response(resp);
+  return this->send_state_or_defer_(this->send_text_sensor_state_response(resp), DeferredStateType::TEXT_SENSOR,
+                                    text_sensor);
 }
 bool APIConnection::send_text_sensor_info(text_sensor::TextSensor *text_sensor) {
   ListEntitiesTextSensorResponse msg;
@@ -446,6 +489,8 @@ bool APIConnection::send_text_sensor_info(text_sensor::TextSensor *text_sensor)
 bool APIConnection::send_climate_state(climate::Climate *climate) {
   if (!this->state_subscription_)
     return false;
+  if (this->is_state_deferred_(climate))
+    return true;
 
   auto traits = climate->get_traits();
   ClimateStateResponse resp{};
@@ -466,7 +511,7 @@ bool APIConnection::send_climate_state(climate::Climate *climate) {
     resp.fan_mode = static_cast<enums::ClimateFanMode>(climate->fan_mode);
   if (traits.get_supports_swing_modes())
     resp.swing_mode = static_cast<enums::ClimateSwingMode>(climate->swing_mode);
-  return this->send_climate_state_response(resp);
+  return this->send_state_or_defer_(this->send_climate_state_response(resp), DeferredStateType::CLIMATE, climate);
 }
 bool APIConnection::send_climate_info(climate::Climate *climate) {
   auto traits = climate->get_traits();
@@ -551,6 +596,41 @@ void APIConnection::camera_image(const CameraImageRequest &msg) {
 }
 #endif
 
+#ifdef USE_PROFILER
+static void fill_profiler_stats(ProfilerStats &msg, const ProfileStats &stats) {
+  msg.count = stats.get_count();
+  msg.min_us = stats.get_min_us();
+  msg.max_us = stats.get_max_us();
+  msg.total_us = stats.get_total_us();
+  msg.buckets.reserve(PROFILE_STATS_BUCKETS);
+  for (uint8_t i = 0; i < PROFILE_STATS_BUCKETS; i++)
+    msg.buckets.push_back(stats.get_bucket(i));
+}
+void APIConnection::profiler_stats(const ProfilerStatsRequest &msg) {
+  // Split the components over multiple responses so that each one easily fits in the TCP send buffer
+  ProfilerStatsResponse resp;
+  uint32_t size = 0;
+  for (auto *comp : App.get_components()) {
+    ProfilerComponentStats stats;
+    stats.name = comp->get_component_source();
+    fill_profiler_stats(stats.loop, comp->get_loop_stats());
+    fill_profiler_stats(stats.scheduler, comp->get_scheduler_stats());
+    ProtoSize::add_message_field<ProfilerComponentStats>(size, 1, stats, true);
+    resp.components.push_back(std::move(stats));
+    if (size >= 1024) {
+      if (!this->send_profiler_stats_response(resp)) {
+        this->on_fatal_error();
+        return;
+      }
+      resp.components.clear();
+      size = 0;
+    }
+  }
+  if (!resp.components.empty() && !this->send_profiler_stats_response(resp))
+    this->on_fatal_error();
+}
+#endif
+
 #ifdef USE_HOMEASSISTANT_TIME
 void APIConnection::on_get_time_response(const GetTimeResponse &value) {
   if (homeassistant::global_homeassistant_time != nullptr)
@@ -563,17 +643,19 @@ bool APIConnection::send_log_message(int level, const char *tag, const char *lin
     return false;
 
   // Send raw so that we don't copy too much
-  auto buffer = this->create_buffer();
+  const size_t line_length = strlen(line);
+  // level field plus tag and length of message field
+  auto buffer = this->create_buffer(line_length + 8);
   // LogLevel level = 1;
   buffer.encode_uint32(1, static_cast<uint32_t>(level));
   // string tag = 2;
   // buffer.encode_string(2, tag, strlen(tag));
   // string message = 3;
-  buffer.encode_string(3, line, strlen(line));
+  buffer.encode_string(3, line, line_length);
   // SubscribeLogsResponse - 29
   bool success = this->send_buffer(buffer, 29);
   if (!success) {
-    buffer = this->create_buffer();
+    buffer = this->create_buffer(2);
     // bool send_failed = 4;
     buffer.encode_bool(4, true);
     return this->send_buffer(buffer, 29);
@@ -653,18 +735,113 @@ void APIConnection::subscribe_home_assistant_states(const SubscribeHomeAssistant
     }
   }
 }
+bool APIConnection::is_state_deferred_(Nameable *entity) const {
+  if (this->processing_deferred_states_ || this->deferred_states_.empty())
+    return false;
+  const uint32_t key = entity->get_object_id_hash();
+  for (const auto &item : this->deferred_states_) {
+    if (item.key == key)
+      return true;
+  }
+  return false;
+}
+bool APIConnection::send_state_or_defer_(bool sent, DeferredStateType type, Nameable *entity) {
+  if (sent || this->processing_deferred_states_)
+    return sent;
+  this->deferred_states_.push_back(DeferredState{
+      .key = entity->get_object_id_hash(),
+      .type = type,
+      .entity = entity,
+  });
+  // the latest state will be sent from loop() once there's space in the TCP buffer
+  return true;
+}
+bool APIConnection::send_deferred_state_(const DeferredState &item) {
+  switch (item.type) {
+#ifdef USE_BINARY_SENSOR
+    case DeferredStateType::BINARY_SENSOR: {
+      auto *obj = static_cast<binary_sensor::BinarySensor *>(item.entity);
+      return this->send_binary_sensor_state(obj, obj->state);
+    }
+#endif
+#ifdef USE_COVER
+    case DeferredStateType::COVER:
+      return this->send_cover_state(static_cast<cover::Cover *>(item.entity));
+#endif
+#ifdef USE_FAN
+    case DeferredStateType::FAN:
+      return this->send_fan_state(static_cast<fan::FanState *>(item.entity));
+#endif
+#ifdef USE_LIGHT
+    case DeferredStateType::LIGHT:
+      return this->send_light_state(static_cast<light::LightState *>(item.entity));
+#endif
+#ifdef USE_SENSOR
+    case DeferredStateType::SENSOR: {
+      auto *obj = static_cast<sensor::Sensor *>(item.entity);
+      return this->send_sensor_state(obj, obj->state);
+    }
+#endif
+#ifdef USE_SWITCH
+    case DeferredStateType::SWITCH: {
+      auto *obj = static_cast<switch_::Switch *>(item.entity);
+      return this->send_switch_state(obj, obj->state);
+    }
+#endif
+#ifdef USE_TEXT_SENSOR
+    case DeferredStateType::TEXT_SENSOR: {
+      auto *obj = static_cast<text_sensor::TextSensor *>(item.entity);
+      return this->send_text_sensor_state(obj, obj->state);
+    }
+#endif
+#ifdef USE_CLIMATE
+    case DeferredStateType::CLIMATE:
+      return this->send_climate_state(static_cast<climate::Climate *>(item.entity));
+#endif
+    default:
+      // entity type not compiled in, drop it
+      return true;
+  }
+}
+void APIConnection::process_deferred_states_() {
+  if (this->deferred_states_.empty())
+    return;
+  if (!this->state_subscription_) {
+    this->deferred_states_.clear();
+    return;
+  }
+
+  this->processing_deferred_states_ = true;
+  size_t sent = 0;
+  for (const auto &item : this->deferred_states_) {
+    if (!this->send_deferred_state_(item))
+      // still no space, try again in next loop
+      break;
+    sent++;
+  }
+  this->processing_deferred_states_ = false;
+  this->deferred_states_.erase(this->deferred_states_.begin(), this->deferred_states_.begin() + sent);
+}
 bool APIConnection::send_buffer(ProtoWriteBuffer buffer, uint32_t message_type) {
   if (this->remove_)
     return false;
 
-  std::vector<uint8_t> header;
-  header.push_back(0x00);
-  ProtoVarInt(buffer.get_buffer()->size()).encode(header);
-  ProtoVarInt(message_type).encode(header);
+  // The payload starts after FRAME_HEADER_PADDING bytes, write the header right in front of it
+  // so that the whole frame can be added in one go.
+  std::vector<uint8_t> *raw_buffer = buffer.get_buffer();
+  const uint32_t payload_size = raw_buffer->size() - FRAME_HEADER_PADDING;
+  const uint8_t header_size = 1 + ProtoSize::varint(payload_size) + ProtoSize::varint(message_type);
+  uint8_t *frame = raw_buffer->data() + FRAME_HEADER_PADDING - header_size;
+  frame[0] = 0x00;
+  uint32_t i = 1;
+  i += ProtoVarInt(payload_size).encode_to_buffer_unchecked(&frame[i]);
+  ProtoVarInt(message_type).encode_to_buffer_unchecked(&frame[i]);
 
-  size_t needed_space = buffer.get_buffer()->size() + header.size();
+  size_t needed_space = header_size + payload_size;
 
   if (needed_space > this->client_->space()) {
+    // push out what's queued already so that lwIP can free up space
+    this->flush_();
     delay(0);
     if (needed_space > this->client_->space()) {
       // SubscribeLogsResponse
@@ -676,10 +853,17 @@ bool APIConnection::send_buffer(ProtoWriteBuffer buffer, uint32_t message_type)
     }
   }
 
-  this->client_->add(reinterpret_cast<char *>(header.data()), header.size());
-  this->client_->add(reinterpret_cast<char *>(buffer.get_buffer()->data()), buffer.get_buffer()->size());
-  bool ret = this->client_->send();
-  return ret;
+  // Only queue the frame here, all frames queued during one loop iteration are sent together in flush_().
+  // This way bursts of state updates end up in as few TCP segments as possible.
+  // The space check above should make sure the whole frame fits. If only a part of it was queued anyway, the next
+  // frame would be appended to a truncated one and the client couldn't parse the stream anymore.
+  if (this->client_->add(reinterpret_cast<char *>(frame), needed_space) != needed_space) {
+    ESP_LOGW(TAG, "Queueing message of %u bytes failed, disconnecting %s", needed_space, this->client_info_.c_str());
+    this->on_fatal_error();
+    return false;
+  }
+  this->send_pending_ = true;
+  return true;
 }
 void APIConnection::on_unauthenticated_access() {
   ESP_LOGD(TAG, "'%s' tried to access without authentication.", this->client_info_.c_str());
@@ -62,6 +62,9 @@ class APIConnection : public APIServerConnection {
   bool send_climate_state(climate::Climate *climate);
   bool send_climate_info(climate::Climate *climate);
   void climate_command(const ClimateCommandRequest &msg) override;
+#endif
+#ifdef USE_PROFILER
+  void profiler_stats(const ProfilerStatsRequest &msg) override;
 #endif
   bool send_log_message(int level, const char *tag, const char *line);
   void send_homeassistant_service_call(const HomeassistantServiceResponse &call) {
@@ -124,8 +127,11 @@ class APIConnection : public APIServerConnection {
   void on_fatal_error() override;
   void on_unauthenticated_access() override;
   void on_no_setup_connection() override;
-  ProtoWriteBuffer create_buffer() override {
+  ProtoWriteBuffer create_buffer(uint32_t reserve_size) override {
     this->send_buffer_.clear();
+    this->send_buffer_.reserve(FRAME_HEADER_PADDING + reserve_size);
+    // leave room for the frame header, it's written by send_buffer() once the payload size is known
+    this->send_buffer_.resize(FRAME_HEADER_PADDING);
     return {&this->send_buffer_};
   }
   bool send_buffer(ProtoWriteBuffer buffer, uint32_t message_type) override;
@@ -133,11 +139,44 @@ class APIConnection : public APIServerConnection {
  protected:
   friend APIServer;
 
+  /// Preamble byte plus the largest possible varints for message size and type.
+  static const uint8_t FRAME_HEADER_PADDING = 1 + 5 + 5;
+
   void on_error_(int8_t error);
   void on_disconnect_();
   void on_timeout_(uint32_t time);
   void on_data_(uint8_t *buf, size_t len);
   void parse_recv_buffer_();
+  /// Send all frames queued by send_buffer().
+  void flush_();
+
+  enum class DeferredStateType : uint8_t {
+    BINARY_SENSOR,
+    COVER,
+    FAN,
+    LIGHT,
+    SENSOR,
+    SWITCH,
+    TEXT_SENSOR,
+    CLIMATE,
+  };
+  /// A state update that could not be sent because the TCP buffer was full.
+  struct DeferredState {
+    uint32_t key;
+    DeferredStateType type;
+    Nameable *entity;
+  };
+
+  /// Whether a state update for this entity is already waiting to be sent.
+  bool is_state_deferred_(Nameable *entity) const;
+  /** Queue the entity for a state resend if the message could not be sent.
+   *
+   * Only one entry per entity is kept, the state itself is read from the entity when the queue is
+   * drained so superseded values are never sent. The queue is thus bounded by the number of entities.
+   */
+  bool send_state_or_defer_(bool sent, DeferredStateType type, Nameable *entity);
+  bool send_deferred_state_(const DeferredState &item);
+  void process_deferred_states_();
 
   enum class ConnectionState {
     WAITING_FOR_HELLO,
@@ -148,7 +187,12 @@ class APIConnection : public APIServerConnection {
   bool remove_{false};
 
   std::vector<uint8_t> send_buffer_;
+  /// Received data, bytes between recv_start_ and recv_end_ haven't been parsed yet.
   std::vector<uint8_t> recv_buffer_;
+  size_t recv_start_{0};
+  size_t recv_end_{0};
+  std::vector<DeferredState> deferred_states_;
+  bool processing_deferred_states_{false};
 
   std::string client_info_;
 #ifdef USE_ESP32_CAMERA
@@ -161,6 +205,7 @@ class APIConnection : public APIServerConnection {
   bool sent_ping_{false};
   bool service_call_subscription_{false};
   bool current_nodelay_{false};
+  bool send_pending_{false};
   bool next_close_{false};
   AsyncClient *client_;
   APIServer *parent_;
@@ -184,6 +184,14 @@ bool APIServerConnectionBase::send_climate_state_response(const ClimateStateResp
 #endif
 #ifdef USE_CLIMATE
 #endif
+#ifdef USE_PROFILER
+#endif
+#ifdef USE_PROFILER
+bool APIServerConnectionBase::send_profiler_stats_response(const ProfilerStatsResponse &msg) {
+  ESP_LOGVV(TAG, "send_profiler_stats_response: %s", msg.dump().c_str());
+  return this->send_message_<ProfilerStatsResponse>(msg, 50);
+}
+#endif
 bool APIServerConnectionBase::read_message(uint32_t msg_size, uint32_t msg_type, uint8_t *msg_data) {
   switch (msg_type) {
     case 1: {
@@ -349,6 +357,15 @@ bool APIServerConnectionBase::read_message(uint32_t msg_size, uint32_t msg_type,
       msg.decode(msg_data, msg_size);
       ESP_LOGVV(TAG, "on_climate_command_request: %s", msg.dump().c_str());
       this->on_climate_command_request(msg);
+#endif
+      break;
+    }
+    case 49: {
+#ifdef USE_PROFILER
+      ProfilerStatsRequest msg;
+      msg.decode(msg_data, msg_size);
+      ESP_LOGVV(TAG, "on_profiler_stats_request: %s", msg.dump().c_str());
+      this->on_profiler_stats_request(msg);
 #endif
       break;
     }
@@ -547,6 +564,19 @@ void APIServerConnection::on_climate_command_request(const ClimateCommandRequest
   this->climate_command(msg);
 }
 #endif
+#ifdef USE_PROFILER
+void APIServerConnection::on_profiler_stats_request(const ProfilerStatsRequest &msg) {
+  if (!this->is_connection_setup()) {
+    this->on_no_setup_connection();
+    return;
+  }
+  if (!this->is_authenticated()) {
+    this->on_unauthenticated_access();
+    return;
+  }
+  this->profiler_stats(msg);
+}
+#endif
 
 }  // namespace api
 }  // namespace esphome
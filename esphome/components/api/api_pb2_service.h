@@ -111,6 +111,12 @@ class APIServerConnectionBase : public ProtoService {
 #endif
 #ifdef USE_CLIMATE
   virtual void on_climate_command_request(const ClimateCommandRequest &value){};
+#endif
+#ifdef USE_PROFILER
+  virtual void on_profiler_stats_request(const ProfilerStatsRequest &value){};
+#endif
+#ifdef USE_PROFILER
+  bool send_profiler_stats_response(const ProfilerStatsResponse &msg);
 #endif
  protected:
   bool read_message(uint32_t msg_size, uint32_t msg_type, uint8_t *msg_data) override;
@@ -147,6 +153,9 @@ class APIServerConnection : public APIServerConnectionBase {
 #endif
 #ifdef USE_CLIMATE
   virtual void climate_command(const ClimateCommandRequest &msg) = 0;
+#endif
+#ifdef USE_PROFILER
+  virtual void profiler_stats(const ProfilerStatsRequest &msg) = 0;
 #endif
  protected:
   void on_hello_request(const HelloRequest &msg) override;
@@ -179,6 +188,9 @@ class APIServerConnection : public APIServerConnectionBase {
 #ifdef USE_CLIMATE
   void on_climate_command_request(const ClimateCommandRequest &msg) override;
 #endif
+#ifdef USE_PROFILER
+  void on_profiler_stats_request(const ProfilerStatsRequest &msg) override;
+#endif
 };
 
 }  // namespace api
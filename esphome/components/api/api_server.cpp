@@ -231,6 +231,7 @@ bool APIServer::is_connected() const { return !this->clients_.empty(); }
 void APIServer::on_shutdown() {
   for (auto *c : this->clients_) {
     c->send_disconnect_request(DisconnectRequest());
+    c->flush_();
   }
   delay(10);
 }
@@ -6,7 +6,7 @@
 namespace esphome {
 namespace api {
 
-/// Representation of a VarInt - in ProtoBuf should be 64bit but we only use 32bit
+/// Representation of a 64 bit ProtoBuf VarInt
 class ProtoVarInt {
  public:
   ProtoVarInt() : value_(0) {}
@@ -62,8 +62,19 @@ class ProtoVarInt {
     else
       return static_cast<int64_t>(this->value_ >> 1);
   }
+  /// Encode into a raw buffer that has at least ProtoSize::varint() bytes of space, returns the bytes written.
+  uint32_t encode_to_buffer_unchecked(uint8_t *buffer) const {
+    uint64_t val = this->value_;
+    uint32_t i = 0;
+    do {
+      uint8_t temp = val & 0x7F;
+      val >>= 7;
+      buffer[i++] = val ? (temp | 0x80) : temp;
+    } while (val);
+    return i;
+  }
   void encode(std::vector<uint8_t> &out) {
-    uint32_t val = this->value_;
+    uint64_t val = this->value_;
     if (val <= 0x7F) {
       out.push_back(val);
       return;
@@ -151,11 +162,10 @@ class ProtoWriteBuffer {
     this->encode_field_raw(field_id, 2);
     this->encode_varint_raw(len);
     auto *data = reinterpret_cast<const uint8_t *>(string);
-    for (size_t i = 0; i < len; i++)
-      this->write(data[i]);
+    this->buffer_->insert(this->buffer_->end(), data, data + len);
   }
   void encode_string(uint32_t field_id, const std::string &value, bool force = false) {
-    this->encode_string(field_id, value.data(), value.size());
+    this->encode_string(field_id, value.data(), value.size(), force);
   }
   void encode_bytes(uint32_t field_id, const uint8_t *data, size_t len, bool force = false) {
     this->encode_string(field_id, reinterpret_cast<const char *>(data), len, force);
@@ -200,7 +210,7 @@ class ProtoWriteBuffer {
       uint32_t raw;
     } val{};
     val.value = value;
-    this->encode_fixed32(field_id, val.raw);
+    this->encode_fixed32(field_id, val.raw, force);
   }
   void encode_int32(uint32_t field_id, int32_t value, bool force = false) {
     if (value < 0) {
@@ -223,15 +233,11 @@ class ProtoWriteBuffer {
   }
   template<class C> void encode_message(uint32_t field_id, const C &value, bool force = false) {
     this->encode_field_raw(field_id, 2);
-    size_t begin = this->buffer_->size();
-
+    // size is known upfront, so the length prefix can be written before the nested message
+    uint32_t nested_length = 0;
+    value.calculate_size(nested_length);
+    this->encode_varint_raw(nested_length);
     value.encode(*this);
-
-    const uint32_t nested_length = this->buffer_->size() - begin;
-    // add size varint
-    std::vector<uint8_t> var;
-    ProtoVarInt(nested_length).encode(var);
-    this->buffer_->insert(this->buffer_->begin() + begin, var.begin(), var.end());
   }
   std::vector<uint8_t> *get_buffer() const { return buffer_; }
 
@@ -239,9 +245,117 @@ class ProtoWriteBuffer {
   std::vector<uint8_t> *buffer_;
 };
 
+/// Helpers to calculate the encoded size of fields, mirroring the encode_* methods of ProtoWriteBuffer.
+class ProtoSize {
+ public:
+  static uint32_t varint(uint32_t value) {
+    if (value < (1 << 7))
+      return 1;
+    if (value < (1 << 14))
+      return 2;
+    if (value < (1 << 21))
+      return 3;
+    if (value < (1 << 28))
+      return 4;
+    return 5;
+  }
+  static uint32_t field(uint32_t field_id, uint32_t type) { return varint((field_id << 3) | (type & 0b111)); }
+  static void add_uint32_field(uint32_t &total_size, uint32_t field_id, uint32_t value, bool force = false) {
+    if (value == 0 && !force)
+      return;
+    total_size += field(field_id, 0) + varint(value);
+  }
+  static void add_uint64_field(uint32_t &total_size, uint32_t field_id, uint64_t value, bool force = false) {
+    if (value == 0 && !force)
+      return;
+    uint32_t bytes = 1;
+    while (value >= 0x80) {
+      value >>= 7;
+      bytes++;
+    }
+    total_size += field(field_id, 0) + bytes;
+  }
+  static void add_int32_field(uint32_t &total_size, uint32_t field_id, int32_t value, bool force = false) {
+    // varints are encoded with 32 bits, so negative values take 5 bytes
+    add_uint32_field(total_size, field_id, static_cast<uint32_t>(value), force);
+  }
+  static void add_sint32_field(uint32_t &total_size, uint32_t field_id, int32_t value, bool force = false) {
+    uint32_t uvalue;
+    if (value < 0)
+      uvalue = ~(value << 1);
+    else
+      uvalue = value << 1;
+    add_uint32_field(total_size, field_id, uvalue, force);
+  }
+  static void add_int64_field(uint32_t &total_size, uint32_t field_id, int64_t value, bool force = false) {
+    add_uint64_field(total_size, field_id, static_cast<uint64_t>(value), force);
+  }
+  static void add_sint64_field(uint32_t &total_size, uint32_t field_id, int64_t value, bool force = false) {
+    uint64_t uvalue;
+    if (value < 0)
+      uvalue = ~(static_cast<uint64_t>(value) << 1);
+    else
+      uvalue = static_cast<uint64_t>(value) << 1;
+    add_uint64_field(total_size, field_id, uvalue, force);
+  }
+  template<typename T>
+  static void add_enum_field(uint32_t &total_size, uint32_t field_id, T value, bool force = false) {
+    add_uint32_field(total_size, field_id, static_cast<uint32_t>(value), force);
+  }
+  static void add_bool_field(uint32_t &total_size, uint32_t field_id, bool value, bool force = false) {
+    if (!value && !force)
+      return;
+    total_size += field(field_id, 0) + 1;
+  }
+  static void add_fixed32_field(uint32_t &total_size, uint32_t field_id, uint32_t value, bool force = false) {
+    if (value == 0 && !force)
+      return;
+    total_size += field(field_id, 5) + 4;
+  }
+  static void add_sfixed32_field(uint32_t &total_size, uint32_t field_id, int32_t value, bool force = false) {
+    if (value == 0 && !force)
+      return;
+    total_size += field(field_id, 5) + 4;
+  }
+  static void add_fixed64_field(uint32_t &total_size, uint32_t field_id, uint64_t value, bool force = false) {
+    if (value == 0 && !force)
+      return;
+    total_size += field(field_id, 1) + 8;
+  }
+  static void add_sfixed64_field(uint32_t &total_size, uint32_t field_id, int64_t value, bool force = false) {
+    if (value == 0 && !force)
+      return;
+    total_size += field(field_id, 1) + 8;
+  }
+  static void add_float_field(uint32_t &total_size, uint32_t field_id, float value, bool force = false) {
+    if (value == 0.0f && !force)
+      return;
+    total_size += field(field_id, 5) + 4;
+  }
+  static void add_double_field(uint32_t &total_size, uint32_t field_id, double value, bool force = false) {
+    if (value == 0.0 && !force)
+      return;
+    total_size += field(field_id, 1) + 8;
+  }
+  static void add_string_field(uint32_t &total_size, uint32_t field_id, const std::string &value,
+                               bool force = false) {
+    if (value.empty() && !force)
+      return;
+    total_size += field(field_id, 2) + varint(value.size()) + value.size();
+  }
+  template<class C>
+  static void add_message_field(uint32_t &total_size, uint32_t field_id, const C &value, bool force = false) {
+    uint32_t nested_length = 0;
+    value.calculate_size(nested_length);
+    total_size += field(field_id, 2) + varint(nested_length) + nested_length;
+  }
+};
+
 class ProtoMessage {
  public:
   virtual void encode(ProtoWriteBuffer buffer) const = 0;
+  /// Add the encoded size of this message to total_size.
+  virtual void calculate_size(uint32_t &total_size) const = 0;
   void decode(const uint8_t *buffer, size_t length);
   std::string dump() const;
   virtual void dump_to(std::string &out) const = 0;
@@ -263,12 +377,15 @@ class ProtoService {
   virtual void on_fatal_error() = 0;
   virtual void on_unauthenticated_access() = 0;
   virtual void on_no_setup_connection() = 0;
-  virtual ProtoWriteBuffer create_buffer() = 0;
+  /// Create a buffer with room for at least reserve_size bytes of payload.
+  virtual ProtoWriteBuffer create_buffer(uint32_t reserve_size) = 0;
   virtual bool send_buffer(ProtoWriteBuffer buffer, uint32_t message_type) = 0;
   virtual bool read_message(uint32_t msg_size, uint32_t msg_type, uint8_t *msg_data) = 0;
 
   template<class C> bool send_message_(const C &msg, uint32_t message_type) {
-    auto buffer = this->create_buffer();
+    uint32_t msg_size = 0;
+    msg.calculate_size(msg_size);
+    auto buffer = this->create_buffer(msg_size);
     msg.encode(buffer);
     return this->send_buffer(buffer, message_type);
   }
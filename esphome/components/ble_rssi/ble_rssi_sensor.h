@@ -32,6 +32,11 @@ class BLERSSISensor : public sensor::Sensor, public esp32_ble_tracker::ESPBTDevi
       this->publish_state(NAN);
     this->found_ = false;
   }
+  esp32_ble_tracker::ESPBTListenerInterest get_interest() const override {
+    if (this->by_address_)
+      return esp32_ble_tracker::ESPBTListenerInterest::for_address(this->address_);
+    return esp32_ble_tracker::ESPBTListenerInterest::for_service_uuid(this->uuid_);
+  }
   bool parse_device(const esp32_ble_tracker::ESPBTDevice &device) override {
     if (this->by_address_) {
       if (device.address_uint64() == this->address_) {
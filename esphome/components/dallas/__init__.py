@@ -1,9 +1,10 @@
 import esphome.codegen as cg
 import esphome.config_validation as cv
 from esphome import pins
-from esphome.const import CONF_ID, CONF_PIN, \
+from esphome.const import CONF_ID, CONF_PIN, CONF_HARDWARE_UART, \
     CONF_RESOLUTION, CONF_UNIT_OF_MEASUREMENT, UNIT_CELSIUS, \
-    CONF_ICON, ICON_THERMOMETER, CONF_ACCURACY_DECIMALS
+    CONF_ICON, ICON_THERMOMETER, CONF_ACCURACY_DECIMALS, CONF_RX_PIN, CONF_TX_PIN
+from esphome.core import CORE
 
 MULTI_CONF = True
 AUTO_LOAD = ['sensor']
@@ -16,11 +17,65 @@ SENSOR_NAME_TEMPLATE_DEFAULT = '%s.%s'
 dallas_ns = cg.esphome_ns.namespace('dallas')
 DallasComponent = dallas_ns.class_('DallasComponent', cg.PollingComponent)
 ESPOneWire = dallas_ns.class_('ESPOneWire')
+ESP32UARTOneWire = dallas_ns.class_('ESP32UARTOneWire', ESPOneWire)
+
+HARDWARE_UARTS = {
+    'UART1': 1,
+    'UART2': 2,
+}
+
+
+def _pin_number(value, default):
+    if value is None:
+        return default
+    try:
+        return pins.validate_gpio_pin(value)
+    except cv.Invalid:
+        # Reported by the component that owns the pin
+        return None
+
+
+def _hardware_uart_users():
+    """Map each hardware UART to what else claims it in the raw configuration."""
+    users = {}
+    logger = CORE.raw_config.get('logger') or {}
+    if CONF_HARDWARE_UART in logger:
+        users[str(logger[CONF_HARDWARE_UART]).upper()] = 'logger'
+    # Mirrors UARTComponent::setup() on the ESP32: buses on the default pins use Serial (UART0),
+    # all others take the next HardwareSerial number starting at 1.
+    buses = CORE.raw_config.get('uart') or []
+    if isinstance(buses, dict):
+        buses = [buses]
+    uart_num = 1
+    for bus in buses:
+        if not isinstance(bus, dict):
+            continue
+        if _pin_number(bus.get(CONF_TX_PIN), 1) == 1 and _pin_number(bus.get(CONF_RX_PIN), 3) == 3:
+            continue
+        users.setdefault(f'UART{uart_num}', 'uart')
+        uart_num += 1
+    return users
+
+
+def validate_hardware_uart(value):
+    user = _hardware_uart_users().get(value)
+    if user is not None:
+        raise cv.Invalid(f"{value} is already used by the {user} component, please choose another UART")
+    hubs = CORE.raw_config.get('dallas') or []
+    if isinstance(hubs, dict):
+        hubs = [hubs]
+    if sum(1 for hub in hubs
+           if isinstance(hub, dict) and str(hub.get(CONF_HARDWARE_UART, '')).upper() == value) > 1:
+        raise cv.Invalid(f"{value} is used by more than one dallas hub")
+    return value
+
 
 CONFIG_SCHEMA = cv.Schema({
     cv.GenerateID(): cv.declare_id(DallasComponent),
     cv.GenerateID(CONF_ONE_WIRE_ID): cv.declare_id(ESPOneWire),
     cv.Required(CONF_PIN): pins.gpio_input_pin_schema,
+    cv.Optional(CONF_HARDWARE_UART): cv.All(cv.only_on_esp32, cv.one_of(*HARDWARE_UARTS, upper=True),
+                                            validate_hardware_uart),
     cv.Optional(CONF_AUTO_SETUP_SENSORS, default=False): cv.boolean,
     cv.Optional(CONF_SENSOR_NAME_TEMPLATE, default=SENSOR_NAME_TEMPLATE_DEFAULT): cv.string_strict,
     cv.Optional(CONF_RESOLUTION, default=12): cv.int_range(min=9, max=12),
@@ -32,7 +87,11 @@ CONFIG_SCHEMA = cv.Schema({
 
 def to_code(config):
     pin = yield cg.gpio_pin_expression(config[CONF_PIN])
-    one_wire = cg.new_Pvariable(config[CONF_ONE_WIRE_ID], pin)
+    if CONF_HARDWARE_UART in config:
+        rhs = ESP32UARTOneWire.new(pin, HARDWARE_UARTS[config[CONF_HARDWARE_UART]])
+        one_wire = cg.Pvariable(config[CONF_ONE_WIRE_ID], rhs)
+    else:
+        one_wire = cg.new_Pvariable(config[CONF_ONE_WIRE_ID], pin)
     var = cg.new_Pvariable(config[CONF_ID], one_wire)
     if CONF_AUTO_SETUP_SENSORS in config:
         cg.add(var.set_auto_setup_sensors(config[CONF_AUTO_SETUP_SENSORS]))
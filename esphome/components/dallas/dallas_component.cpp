@@ -1,6 +1,7 @@
 #include "dallas_component.h"
 #include "esphome/core/log.h"
 #include "esphome/core/application.h"
+#include <algorithm>
 
 namespace esphome {
 namespace dallas {
@@ -32,13 +33,14 @@ uint16_t DallasTemperatureSensor::millis_to_wait_for_conversion() const {
 void DallasComponent::setup() {
   ESP_LOGCONFIG(TAG, "Setting up DallasComponent...");
 
-  yield();
-  std::vector<uint64_t> raw_sensors;
-  {
-    InterruptLock lock;
-    raw_sensors = this->one_wire_->search_vec();
+  if (!this->one_wire_->setup()) {
+    this->mark_failed();
+    return;
   }
 
+  yield();
+  std::vector<uint64_t> raw_sensors = this->one_wire_->search_vec();
+
   for (auto &address : raw_sensors) {
     std::string s = uint64_to_string(address);
     auto *address8 = reinterpret_cast<uint8_t *>(&address);
@@ -134,50 +136,55 @@ DallasTemperatureSensor *DallasComponent::get_sensor_by_index(uint8_t index, uin
 void DallasComponent::update() {
   this->status_clear_warning();
 
-  bool result;
-  {
-    InterruptLock lock;
-    if (!this->one_wire_->reset()) {
-      result = false;
-    } else {
-      result = true;
-      this->one_wire_->skip();
-      this->one_wire_->write8(DALLAS_COMMAND_START_CONVERSION);
-    }
+  if (!this->pending_reads_.empty()) {
+    ESP_LOGW(TAG, "Previous conversion is still being read out, skipping this update.");
+    this->status_set_warning();
+    return;
   }
 
-  if (!result) {
+  if (!this->one_wire_->reset()) {
     ESP_LOGE(TAG, "Requesting conversion failed");
     this->status_set_warning();
     return;
   }
+  this->one_wire_->skip();
+  this->one_wire_->write8(DALLAS_COMMAND_START_CONVERSION);
 
-  for (auto *sensor : this->sensors_) {
-    this->set_timeout(sensor->get_address_name(), sensor->millis_to_wait_for_conversion(), [this, sensor] {
-      bool res;
-      {
-        InterruptLock lock;
-        res = sensor->read_scratch_pad();
-      }
-
-      if (!res) {
-        ESP_LOGW(TAG, "'%s' - Reseting bus for read failed!", sensor->get_name().c_str());
-        sensor->publish_state(NAN);
-        this->status_set_warning();
-        return;
-      }
-      if (!sensor->check_scratch_pad()) {
-        ESP_LOGW(TAG, "'%s' - Scratch pad checksum invalid!", sensor->get_name().c_str());
-        sensor->publish_state(NAN);
-        this->status_set_warning();
-        return;
-      }
-
-      float tempc = sensor->get_temp_c();
-      ESP_LOGD(TAG, "'%s': Got Temperature=%.1f°C", sensor->get_name().c_str(), tempc);
-      sensor->publish_state(tempc);
-    });
+  // All sensors convert at the same time, read them out one per loop iteration in the order they finish
+  // so that many sensors on one bus don't block the main loop all at once.
+  this->conversion_started_ = millis();
+  this->pending_reads_ = this->sensors_;
+  std::stable_sort(this->pending_reads_.begin(), this->pending_reads_.end(),
+                   [](DallasTemperatureSensor *a, DallasTemperatureSensor *b) {
+                     return a->millis_to_wait_for_conversion() < b->millis_to_wait_for_conversion();
+                   });
+}
+void DallasComponent::loop() {
+  if (this->pending_reads_.empty())
+    return;
+  DallasTemperatureSensor *sensor = this->pending_reads_.front();
+  if (millis() - this->conversion_started_ < sensor->millis_to_wait_for_conversion())
+    return;
+  this->pending_reads_.erase(this->pending_reads_.begin());
+  this->read_sensor_(sensor);
+}
+void DallasComponent::read_sensor_(DallasTemperatureSensor *sensor) {
+  if (!sensor->read_scratch_pad()) {
+    ESP_LOGW(TAG, "'%s' - Reseting bus for read failed!", sensor->get_name().c_str());
+    sensor->publish_state(NAN);
+    this->status_set_warning();
+    return;
   }
+  if (!sensor->check_scratch_pad()) {
+    ESP_LOGW(TAG, "'%s' - Scratch pad checksum invalid!", sensor->get_name().c_str());
+    sensor->publish_state(NAN);
+    this->status_set_warning();
+    return;
+  }
+
+  float tempc = sensor->get_temp_c();
+  ESP_LOGD(TAG, "'%s': Got Temperature=%.1f°C", sensor->get_name().c_str(), tempc);
+  sensor->publish_state(tempc);
 }
 DallasComponent::DallasComponent(ESPOneWire *one_wire) : one_wire_(one_wire) {}
 void DallasComponent::set_auto_setup_sensors(bool auto_setup_sensors) {
@@ -212,7 +219,7 @@ const std::string &DallasTemperatureSensor::get_address_name() {
 
   return this->address_name_;
 }
-bool ICACHE_RAM_ATTR DallasTemperatureSensor::read_scratch_pad() {
+bool DallasTemperatureSensor::read_scratch_pad() {
   ESPOneWire *wire = this->parent_->one_wire_;
   if (!wire->reset()) {
     return false;
@@ -227,13 +234,7 @@ bool ICACHE_RAM_ATTR DallasTemperatureSensor::read_scratch_pad() {
   return true;
 }
 bool DallasTemperatureSensor::setup_sensor() {
-  bool r;
-  {
-    InterruptLock lock;
-    r = this->read_scratch_pad();
-  }
-
-  if (!r) {
+  if (!this->read_scratch_pad()) {
     ESP_LOGE(TAG, "Reading scratchpad failed: reset");
     return false;
   }
@@ -266,20 +267,17 @@ bool DallasTemperatureSensor::setup_sensor() {
   }
 
   ESPOneWire *wire = this->parent_->one_wire_;
-  {
-    InterruptLock lock;
-    if (wire->reset()) {
-      wire->select(this->address_);
-      wire->write8(DALLAS_COMMAND_WRITE_SCRATCH_PAD);
-      wire->write8(this->scratch_pad_[2]);  // high alarm temp
-      wire->write8(this->scratch_pad_[3]);  // low alarm temp
-      wire->write8(this->scratch_pad_[4]);  // resolution
-      wire->reset();
+  if (wire->reset()) {
+    wire->select(this->address_);
+    wire->write8(DALLAS_COMMAND_WRITE_SCRATCH_PAD);
+    wire->write8(this->scratch_pad_[2]);  // high alarm temp
+    wire->write8(this->scratch_pad_[3]);  // low alarm temp
+    wire->write8(this->scratch_pad_[4]);  // resolution
+    wire->reset();
 
-      // write value to EEPROM
-      wire->select(this->address_);
-      wire->write8(0x48);
-    }
+    // write value to EEPROM
+    wire->select(this->address_);
+    wire->write8(0x48);
   }
 
   delay(20);  // allow it to finish operation
@@ -21,6 +21,8 @@ class DallasComponent : public PollingComponent {
   float get_setup_priority() const override { return setup_priority::DATA; }
 
   void update() override;
+  /// Read out the sensors of a running conversion, one per loop iteration.
+  void loop() override;
 
   /// Automatic sensors instantiation
   bool get_auto_setup_sensors() const;
@@ -36,8 +38,13 @@ class DallasComponent : public PollingComponent {
  protected:
   friend DallasTemperatureSensor;
 
+  void read_sensor_(DallasTemperatureSensor *sensor);
+
   ESPOneWire *one_wire_;
   std::vector<DallasTemperatureSensor *> sensors_;
+  /// Sensors of the running conversion that still have to be read, sorted by conversion time.
+  std::vector<DallasTemperatureSensor *> pending_reads_;
+  uint32_t conversion_started_{0};
   std::vector<uint64_t> found_sensors_;
 
   bool auto_setup_sensors_;
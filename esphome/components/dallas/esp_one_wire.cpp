@@ -2,6 +2,12 @@
 #include "esphome/core/log.h"
 #include "esphome/core/helpers.h"
 
+#ifdef ARDUINO_ARCH_ESP32
+#include <driver/gpio.h>
+#include <driver/uart.h>
+#include <soc/gpio_sig_map.h>
+#endif
+
 namespace esphome {
 namespace dallas {
 
@@ -13,6 +19,7 @@ const int ONE_WIRE_ROM_SEARCH = 0xF0;
 ESPOneWire::ESPOneWire(GPIOPin *pin) : pin_(pin) {}
 
 bool HOT ICACHE_RAM_ATTR ESPOneWire::reset() {
+  InterruptLock lock;
   uint8_t retries = 125;
 
   // Wait for communication to clear
@@ -40,6 +47,7 @@ bool HOT ICACHE_RAM_ATTR ESPOneWire::reset() {
 }
 
 void HOT ICACHE_RAM_ATTR ESPOneWire::write_bit(bool bit) {
+  InterruptLock lock;
   // Initiate write/read by pulling low.
   this->pin_->pin_mode(OUTPUT);
   this->pin_->digital_write(false);
@@ -61,6 +69,7 @@ void HOT ICACHE_RAM_ATTR ESPOneWire::write_bit(bool bit) {
 }
 
 bool HOT ICACHE_RAM_ATTR ESPOneWire::read_bit() {
+  InterruptLock lock;
   // Initiate read slot by pulling LOW for at least 1µs
   this->pin_->pin_mode(OUTPUT);
   this->pin_->digital_write(false);
@@ -213,5 +222,102 @@ GPIOPin *ESPOneWire::get_pin() { return this->pin_; }
 
 uint8_t ICACHE_RAM_ATTR *ESPOneWire::rom_number8_() { return reinterpret_cast<uint8_t *>(&this->rom_number_); }
 
+#ifdef ARDUINO_ARCH_ESP32
+static const uint32_t ONE_WIRE_UART_RESET_BAUD_RATE = 9600;
+static const uint32_t ONE_WIRE_UART_SLOT_BAUD_RATE = 115200;
+static const uint8_t ONE_WIRE_UART_RESET = 0xF0;
+static const uint8_t ONE_WIRE_UART_SLOT_1 = 0xFF;
+static const uint8_t ONE_WIRE_UART_SLOT_0 = 0x00;
+
+ESP32UARTOneWire::ESP32UARTOneWire(GPIOPin *pin, uint8_t uart_num) : ESPOneWire(pin), uart_num_(uart_num) {}
+
+bool ESP32UARTOneWire::setup() {
+  auto port = uart_port_t(this->uart_num_);
+  auto pin = gpio_num_t(this->pin_->get_pin());
+
+  uart_config_t config{};
+  config.baud_rate = ONE_WIRE_UART_SLOT_BAUD_RATE;
+  config.data_bits = UART_DATA_8_BITS;
+  config.parity = UART_PARITY_DISABLE;
+  config.stop_bits = UART_STOP_BITS_1;
+  config.flow_ctrl = UART_HW_FLOWCTRL_DISABLE;
+  if (uart_param_config(port, &config) != ESP_OK ||
+      uart_set_pin(port, pin, pin, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE) != ESP_OK) {
+    ESP_LOGE(TAG, "Configuring UART%u failed!", this->uart_num_);
+    return false;
+  }
+  // uart_set_pin leaves the shared pin as an input only, turn it into an open drain output again so that the
+  // UART and the devices can both pull the bus low, and re-route the TX signal to it.
+  gpio_set_direction(pin, GPIO_MODE_INPUT_OUTPUT_OD);
+  gpio_set_pull_mode(pin, GPIO_PULLUP_ONLY);
+  gpio_matrix_out(pin, this->uart_num_ == 1 ? U1TXD_OUT_IDX : U2TXD_OUT_IDX, false, false);
+
+  // The RX buffer has to be larger than the hardware FIFO, a single transfer is at most 64 bytes.
+  if (uart_driver_install(port, UART_FIFO_LEN * 2, 0, 0, nullptr, 0) != ESP_OK) {
+    ESP_LOGE(TAG, "Installing UART%u driver failed!", this->uart_num_);
+    return false;
+  }
+  this->baud_rate_ = ONE_WIRE_UART_SLOT_BAUD_RATE;
+  return true;
+}
+void ESP32UARTOneWire::set_baud_rate_(uint32_t baud_rate) {
+  if (this->baud_rate_ == baud_rate)
+    return;
+  uart_wait_tx_done(uart_port_t(this->uart_num_), pdMS_TO_TICKS(10));
+  uart_set_baudrate(uart_port_t(this->uart_num_), baud_rate);
+  this->baud_rate_ = baud_rate;
+}
+bool ESP32UARTOneWire::transfer_(uint8_t *data, size_t len) {
+  auto port = uart_port_t(this->uart_num_);
+  uart_flush_input(port);
+  uart_write_bytes(port, reinterpret_cast<const char *>(data), len);
+  // Each byte takes ~87µs at 115200 baud and ~1ms at 9600 baud, the read blocks the loop task only.
+  int read = uart_read_bytes(port, data, len, pdMS_TO_TICKS(len + 10));
+  return read == int(len);
+}
+bool ESP32UARTOneWire::reset() {
+  this->set_baud_rate_(ONE_WIRE_UART_RESET_BAUD_RATE);
+  uint8_t data = ONE_WIRE_UART_RESET;
+  bool ok = this->transfer_(&data, 1);
+  this->set_baud_rate_(ONE_WIRE_UART_SLOT_BAUD_RATE);
+  // Devices answer with a presence pulse that overwrites some of the high bits of the echo.
+  return ok && data != ONE_WIRE_UART_RESET;
+}
+void ESP32UARTOneWire::write_bit(bool bit) {
+  uint8_t data = bit ? ONE_WIRE_UART_SLOT_1 : ONE_WIRE_UART_SLOT_0;
+  this->transfer_(&data, 1);
+}
+bool ESP32UARTOneWire::read_bit() {
+  uint8_t data = ONE_WIRE_UART_SLOT_1;
+  if (!this->transfer_(&data, 1))
+    return true;
+  return data == ONE_WIRE_UART_SLOT_1;
+}
+void ESP32UARTOneWire::write8(uint8_t val) {
+  uint8_t data[8];
+  for (uint8_t i = 0; i < 8; i++)
+    data[i] = (val & (1u << i)) ? ONE_WIRE_UART_SLOT_1 : ONE_WIRE_UART_SLOT_0;
+  this->transfer_(data, 8);
+}
+void ESP32UARTOneWire::write64(uint64_t val) {
+  uint8_t data[64];
+  for (uint8_t i = 0; i < 64; i++)
+    data[i] = (val & (1ULL << i)) ? ONE_WIRE_UART_SLOT_1 : ONE_WIRE_UART_SLOT_0;
+  this->transfer_(data, 64);
+}
+uint8_t ESP32UARTOneWire::read8() {
+  uint8_t data[8];
+  memset(data, ONE_WIRE_UART_SLOT_1, sizeof(data));
+  if (!this->transfer_(data, 8))
+    return 0xFF;
+  uint8_t ret = 0;
+  for (uint8_t i = 0; i < 8; i++) {
+    if (data[i] == ONE_WIRE_UART_SLOT_1)
+      ret |= 1u << i;
+  }
+  return ret;
+}
+#endif
+
 }  // namespace dallas
 }  // namespace esphome
@@ -9,35 +9,43 @@ namespace dallas {
 extern const uint8_t ONE_WIRE_ROM_SELECT;
 extern const int ONE_WIRE_ROM_SEARCH;
 
+/** Bit-banged 1-Wire bus.
+ *
+ * Interrupts are only disabled for the duration of a single reset pulse or bit slot, the bus
+ * tolerates arbitrarily long gaps between slots.
+ */
 class ESPOneWire {
  public:
   explicit ESPOneWire(GPIOPin *pin);
 
+  /// Prepare the bus hardware, return false if that failed.
+  virtual bool setup() { return true; }
+
   /** Reset the bus, should be done before all write operations.
    *
    * Takes approximately 1ms.
    *
    * @return Whether the operation was successful.
    */
-  bool reset();
+  virtual bool reset();
 
   /// Write a single bit to the bus, takes about 70µs.
-  void write_bit(bool bit);
+  virtual void write_bit(bool bit);
 
   /// Read a single bit from the bus, takes about 70µs
-  bool read_bit();
+  virtual bool read_bit();
 
   /// Write a word to the bus. LSB first.
-  void write8(uint8_t val);
+  virtual void write8(uint8_t val);
 
   /// Write a 64 bit unsigned integer to the bus. LSB first.
-  void write64(uint64_t val);
+  virtual void write64(uint64_t val);
 
   /// Write a command to the bus that addresses all devices by skipping the ROM.
   void skip();
 
   /// Read an 8 bit word from the bus.
-  uint8_t read8();
+  virtual uint8_t read8();
 
   /// Read an 64-bit unsigned integer from the bus.
   uint64_t read64();
@@ -67,5 +75,35 @@ class ESPOneWire {
   uint64_t rom_number_{0};
 };
 
+#ifdef ARDUINO_ARCH_ESP32
+/** 1-Wire bus driven by one of the ESP32 hardware UARTs.
+ *
+ * TX and RX of the UART are both routed to the (open drain) bus pin. A reset is one 0xF0 byte at 9600 baud,
+ * every bit slot is one byte at 115200 baud: 0xFF writes a 1 (or reads a bit), 0x00 writes a 0. The slot
+ * timing is generated by the UART, so no interrupts have to be disabled and a whole byte (8 slots) or
+ * address (64 slots) is sent and read back as a single buffered transfer.
+ */
+class ESP32UARTOneWire : public ESPOneWire {
+ public:
+  ESP32UARTOneWire(GPIOPin *pin, uint8_t uart_num);
+
+  bool setup() override;
+  bool reset() override;
+  void write_bit(bool bit) override;
+  bool read_bit() override;
+  void write8(uint8_t val) override;
+  void write64(uint64_t val) override;
+  uint8_t read8() override;
+
+ protected:
+  /// Send len slot bytes and replace them with the bytes read back from the bus.
+  bool transfer_(uint8_t *data, size_t len);
+  void set_baud_rate_(uint32_t baud_rate);
+
+  uint8_t uart_num_;
+  uint32_t baud_rate_{0};
+};
+#endif
+
 }  // namespace dallas
 }  // namespace esphome
@@ -1,16 +1,41 @@
 import esphome.config_validation as cv
 import esphome.codegen as cg
-from esphome.const import CONF_ID
+from esphome.components import text_sensor
+from esphome.const import CONF_ID, CONF_PROFILER, CONF_TEXT_SENSOR, CONF_UPDATE_INTERVAL
 
 DEPENDENCIES = ['logger']
 
+
+def AUTO_LOAD(config):
+    # text_sensor is only needed for the profiler's text sensor
+    profiler = (config or {}).get(CONF_PROFILER) or {}
+    if isinstance(profiler, dict) and CONF_TEXT_SENSOR in profiler:
+        return ['text_sensor']
+    return []
+
+
 debug_ns = cg.esphome_ns.namespace('debug')
 DebugComponent = debug_ns.class_('DebugComponent', cg.Component)
 CONFIG_SCHEMA = cv.Schema({
     cv.GenerateID(): cv.declare_id(DebugComponent),
+    cv.Optional(CONF_PROFILER): cv.Schema({
+        cv.Optional(CONF_UPDATE_INTERVAL, default='60s'): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_TEXT_SENSOR): text_sensor.TEXT_SENSOR_SCHEMA.extend({
+            cv.GenerateID(): cv.declare_id(text_sensor.TextSensor),
+        }),
+    }),
 }).extend(cv.COMPONENT_SCHEMA)
 
 
 def to_code(config):
     var = cg.new_Pvariable(config[CONF_ID])
     yield cg.register_component(var, config)
+
+    if CONF_PROFILER in config:
+        conf = config[CONF_PROFILER]
+        cg.add_define('USE_PROFILER')
+        cg.add(var.set_profiler_interval(conf[CONF_UPDATE_INTERVAL]))
+        if CONF_TEXT_SENSOR in conf:
+            sens = cg.new_Pvariable(conf[CONF_TEXT_SENSOR][CONF_ID])
+            yield text_sensor.register_text_sensor(sens, conf[CONF_TEXT_SENSOR])
+            cg.add(var.set_profiler_text_sensor(sens))
@@ -3,6 +3,8 @@
 #include "esphome/core/helpers.h"
 #include "esphome/core/defines.h"
 #include "esphome/core/version.h"
+#include "esphome/core/application.h"
+#include <algorithm>
 
 #ifdef ARDUINO_ARCH_ESP32
 #include <rom/rtc.h>
@@ -197,6 +199,11 @@ void DebugComponent::dump_config() {
   ESP_LOGD(TAG, "Reset Info: %s", ESP.getResetInfo().c_str());
 #endif
 }
+void DebugComponent::setup() {
+#ifdef USE_PROFILER
+  this->set_interval("profiler", this->profiler_interval_, [this]() { this->dump_profile_(); });
+#endif
+}
 void DebugComponent::loop() {
   uint32_t new_free_heap = ESP.getFreeHeap();
   if (new_free_heap < this->free_heap_ / 2) {
@@ -207,5 +214,48 @@ void DebugComponent::loop() {
 }
 float DebugComponent::get_setup_priority() const { return setup_priority::LATE; }
 
+#ifdef USE_PROFILER
+void DebugComponent::dump_profile_() {
+  std::vector<std::pair<uint64_t, Component *>> usage;
+  uint64_t total_us = 0;
+
+  ESP_LOGD(TAG, "Loop/scheduler profile:");
+  for (auto *comp : App.get_components()) {
+    ProfileStats &loop = comp->get_loop_stats();
+    ProfileStats &sched = comp->get_scheduler_stats();
+    if (loop.get_count() == 0 && sched.get_count() == 0)
+      continue;
+    ESP_LOGD(TAG, "  %s: loop n=%u avg=%uus max=%uus, scheduler n=%u avg=%uus max=%uus", comp->get_component_source(),
+             loop.get_count(), loop.get_avg_us(), loop.get_max_us(), sched.get_count(), sched.get_avg_us(),
+             sched.get_max_us());
+    uint64_t comp_us = loop.get_total_us() + sched.get_total_us();
+    total_us += comp_us;
+    usage.emplace_back(comp_us, comp);
+  }
+
+#ifdef USE_TEXT_SENSOR
+  if (this->profiler_text_sensor_ == nullptr || total_us == 0)
+    return;
+
+  // Publish the top 5 components by their share of the total measured time
+  const size_t top = std::min<size_t>(usage.size(), 5);
+  std::partial_sort(usage.begin(), usage.begin() + top, usage.end(),
+                    [](const std::pair<uint64_t, Component *> &a, const std::pair<uint64_t, Component *> &b) {
+                      return a.first > b.first;
+                    });
+  std::string state;
+  for (size_t i = 0; i < top; i++) {
+    char buffer[16];
+    snprintf(buffer, sizeof(buffer), " %.1f%%", usage[i].first * 100.0f / total_us);
+    if (!state.empty())
+      state += ", ";
+    state += usage[i].second->get_component_source();
+    state += buffer;
+  }
+  this->profiler_text_sensor_->publish_state(state);
+#endif
+}
+#endif
+
 }  // namespace debug
 }  // namespace esphome
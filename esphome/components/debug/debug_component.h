@@ -1,18 +1,42 @@
 #pragma once
 
 #include "esphome/core/component.h"
+#include "esphome/core/defines.h"
+
+#if defined(USE_PROFILER) && defined(USE_TEXT_SENSOR)
+#include "esphome/components/text_sensor/text_sensor.h"
+#endif
 
 namespace esphome {
 namespace debug {
 
 class DebugComponent : public Component {
  public:
+#ifdef USE_PROFILER
+  /// Set the interval in ms at which the loop/scheduler profile is logged and published.
+  void set_profiler_interval(uint32_t profiler_interval) { this->profiler_interval_ = profiler_interval; }
+#endif
+#if defined(USE_PROFILER) && defined(USE_TEXT_SENSOR)
+  /// Publish the components using the most loop/scheduler time to this text sensor.
+  void set_profiler_text_sensor(text_sensor::TextSensor *profiler_text_sensor) {
+    this->profiler_text_sensor_ = profiler_text_sensor;
+  }
+#endif
+  void setup() override;
   void loop() override;
   float get_setup_priority() const override;
   void dump_config() override;
 
  protected:
   uint32_t free_heap_{};
+#ifdef USE_PROFILER
+  void dump_profile_();
+
+  uint32_t profiler_interval_{60000};
+#endif
+#if defined(USE_PROFILER) && defined(USE_TEXT_SENSOR)
+  text_sensor::TextSensor *profiler_text_sensor_{nullptr};
+#endif
 };
 
 }  // namespace debug
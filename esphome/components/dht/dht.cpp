@@ -1,17 +1,77 @@
 #include "dht.h"
 #include "esphome/core/log.h"
 #include "esphome/core/helpers.h"
+#include <algorithm>
 
 namespace esphome {
 namespace dht {
 
 static const char *TAG = "dht";
 
+/// Time to wait for the complete answer of the sensor, which takes about 5ms.
+static const uint32_t DHT_CAPTURE_TIMEOUT_MS = 20;
+/// High pulses longer than the 80µs sensor response are not part of the answer.
+static const uint8_t DHT_MAX_PULSE_US = 150;
+#ifdef ARDUINO_ARCH_ESP32
+/// The line is idle (high) for good once the sensor has not toggled it for this long.
+static const uint16_t DHT_IDLE_US = 200;
+#endif
+
+#ifdef ARDUINO_ARCH_ESP8266
+void ICACHE_RAM_ATTR DHTPulseStore::gpio_intr(DHTPulseStore *arg) {
+  const uint32_t now = micros();
+  if (arg->isr_pin->digital_read()) {
+    arg->rise_time = now;
+    arg->high = true;
+  } else if (arg->high) {
+    arg->high = false;
+    if (arg->count < DHT_MAX_PULSES) {
+      const uint32_t length = now - arg->rise_time;
+      arg->pulses[arg->count++] = length > 255 ? 255 : length;
+    }
+  }
+}
+#endif
+
 void DHT::setup() {
   ESP_LOGCONFIG(TAG, "Setting up DHT...");
   this->pin_->digital_write(true);
   this->pin_->setup();
   this->pin_->digital_write(true);
+#ifdef ARDUINO_ARCH_ESP32
+  // remote_receiver and remote_transmitter allocate RMT channels from 0 upwards, take ours from the top.
+  // The config validation makes sure that both ends don't meet.
+  static int next_rmt_channel = RMT_CHANNEL_7;
+  if (next_rmt_channel < RMT_CHANNEL_0) {
+    ESP_LOGE(TAG, "No RMT channel left for this DHT, the ESP32 only has %d.", RMT_CHANNEL_MAX);
+    this->mark_failed();
+    return;
+  }
+  this->channel_ = rmt_channel_t(next_rmt_channel--);
+
+  rmt_config_t rmt{};
+  rmt.channel = this->channel_;
+  rmt.gpio_num = gpio_num_t(this->pin_->get_pin());
+  rmt.clk_div = 80;  // 1µs per tick
+  rmt.mem_block_num = 1;
+  rmt.rmt_mode = RMT_MODE_RX;
+  rmt.rx_config.filter_en = true;
+  rmt.rx_config.filter_ticks_thresh = 100;  // in APB clock cycles, ignore glitches shorter than ~1µs
+  rmt.rx_config.idle_threshold = DHT_IDLE_US;
+  esp_err_t error = rmt_config(&rmt);
+  if (error == ESP_OK)
+    error = rmt_driver_install(this->channel_, 1000, 0);
+  if (error == ESP_OK)
+    error = rmt_get_ringbuf_handle(this->channel_, &this->ringbuf_);
+  if (error != ESP_OK) {
+    ESP_LOGE(TAG, "Configuring RMT driver failed: %s", esp_err_to_name(error));
+    this->mark_failed();
+    return;
+  }
+#endif
+#ifdef ARDUINO_ARCH_ESP8266
+  this->store_.isr_pin = this->pin_->to_isr();
+#endif
 }
 void DHT::dump_config() {
   ESP_LOGCONFIG(TAG, "DHT:");
@@ -31,20 +91,107 @@ void DHT::dump_config() {
 }
 
 void DHT::update() {
-  float temperature, humidity;
-  bool error;
-  if (this->model_ == DHT_MODEL_AUTO_DETECT) {
+  if (this->reading_)
+    return;
+  this->detecting_ = this->model_ == DHT_MODEL_AUTO_DETECT;
+  if (this->detecting_)
     this->model_ = DHT_MODEL_DHT22;
-    error = this->read_sensor_(&temperature, &humidity, false);
-    if (error) {
+
+  // Send the start signal. Only its minimum length matters, so it is not timed with interrupts disabled
+  // and the 18ms of the DHT11 pass in the scheduler instead of blocking the loop.
+  this->pin_->digital_write(false);
+  this->pin_->pin_mode(OUTPUT);
+  this->pin_->digital_write(false);
+
+  if (this->model_ == DHT_MODEL_DHT11) {
+    this->set_timeout("start", 18, [this]() { this->start_capture_(); });
+    return;
+  }
+  if (this->model_ == DHT_MODEL_SI7021) {
+    delayMicroseconds(500);
+    this->pin_->digital_write(true);
+    delayMicroseconds(40);
+  } else if (this->model_ == DHT_MODEL_DHT22_TYPE2) {
+    delayMicroseconds(2000);
+  } else {
+    delayMicroseconds(800);
+  }
+  this->start_capture_();
+}
+void DHT::loop() {
+  if (!this->reading_)
+    return;
+
+  uint8_t pulses[DHT_MAX_PULSES];
+  uint8_t count;
+  if (!this->finish_capture_(pulses, &count))
+    return;
+  this->reading_ = false;
+  this->process_capture_(pulses, count);
+}
+void DHT::start_capture_() {
+#ifdef ARDUINO_ARCH_ESP32
+  // Drop anything captured since the last read, then start recording before the line is released.
+  size_t len = 0;
+  void *item;
+  while ((item = xRingbufferReceive(this->ringbuf_, &len, 0)) != nullptr)
+    vRingbufferReturnItem(this->ringbuf_, item);
+  rmt_rx_start(this->channel_, true);
+#endif
+#ifdef ARDUINO_ARCH_ESP8266
+  this->store_.count = 0;
+  this->store_.high = false;
+  this->pin_->attach_interrupt(DHTPulseStore::gpio_intr, &this->store_, CHANGE);
+#endif
+  this->pin_->pin_mode(INPUT_PULLUP);
+  this->capture_started_ = millis();
+  this->reading_ = true;
+}
+bool DHT::finish_capture_(uint8_t *pulses, uint8_t *count) {
+  *count = 0;
+#ifdef ARDUINO_ARCH_ESP32
+  size_t len = 0;
+  auto *item = (rmt_item32_t *) xRingbufferReceive(this->ringbuf_, &len, 0);
+  if (item == nullptr && millis() - this->capture_started_ < DHT_CAPTURE_TIMEOUT_MS)
+    return false;
+  rmt_rx_stop(this->channel_);
+  if (item == nullptr)
+    return true;
+
+  len /= sizeof(rmt_item32_t);
+  for (size_t i = 0; i < len && *count < DHT_MAX_PULSES; i++) {
+    if (item[i].level0 && item[i].duration0 != 0)
+      pulses[(*count)++] = std::min<uint32_t>(item[i].duration0, 255);
+    if (item[i].level1 && item[i].duration1 != 0 && *count < DHT_MAX_PULSES)
+      pulses[(*count)++] = std::min<uint32_t>(item[i].duration1, 255);
+  }
+  vRingbufferReturnItem(this->ringbuf_, item);
+#endif
+#ifdef ARDUINO_ARCH_ESP8266
+  // Host release, sensor response and 40 data bits, stop early once everything is in.
+  if (this->store_.count < 42 && millis() - this->capture_started_ < DHT_CAPTURE_TIMEOUT_MS)
+    return false;
+  this->pin_->detach_interrupt();
+  *count = this->store_.count;
+  for (uint8_t i = 0; i < *count; i++)
+    pulses[i] = this->store_.pulses[i];
+#endif
+  return true;
+}
+void DHT::process_capture_(const uint8_t *pulses, uint8_t count) {
+  float temperature, humidity;
+  bool success;
+  if (this->detecting_) {
+    success = this->read_sensor_(pulses, count, &temperature, &humidity, false);
+    if (!success) {
       this->model_ = DHT_MODEL_DHT11;
       return;
     }
   } else {
-    error = this->read_sensor_(&temperature, &humidity, true);
+    success = this->read_sensor_(pulses, count, &temperature, &humidity, true);
   }
 
-  if (error) {
+  if (success) {
     ESP_LOGD(TAG, "Got Temperature=%.1f°C Humidity=%.1f%%", temperature, humidity);
 
     if (this->temperature_sensor_ != nullptr)
@@ -71,102 +218,34 @@ void DHT::set_dht_model(DHTModel model) {
   this->model_ = model;
   this->is_auto_detect_ = model == DHT_MODEL_AUTO_DETECT;
 }
-bool HOT ICACHE_RAM_ATTR DHT::read_sensor_(float *temperature, float *humidity, bool report_errors) {
+bool DHT::read_sensor_(const uint8_t *pulses, uint8_t count, float *temperature, float *humidity,
+                       bool report_errors) {
   *humidity = NAN;
   *temperature = NAN;
 
-  int error_code = 0;
-  int8_t i = 0;
   uint8_t data[5] = {0, 0, 0, 0, 0};
-
-  {
-    InterruptLock lock;
-
-    this->pin_->digital_write(false);
-    this->pin_->pin_mode(OUTPUT);
-    this->pin_->digital_write(false);
-
-    if (this->model_ == DHT_MODEL_DHT11) {
-      delayMicroseconds(18000);
-    } else if (this->model_ == DHT_MODEL_SI7021) {
-      delayMicroseconds(500);
-      this->pin_->digital_write(true);
-      delayMicroseconds(40);
-    } else if (this->model_ == DHT_MODEL_DHT22_TYPE2) {
-      delayMicroseconds(2000);
+  uint8_t lengths[DHT_MAX_PULSES];
+  uint8_t bits = 0;
+  for (uint8_t i = 0; i < count; i++) {
+    if (pulses[i] <= DHT_MAX_PULSE_US)
+      lengths[bits++] = pulses[i];
+  }
+  if (bits < 40) {
+    if (!report_errors)
+      return false;
+    if (bits == 0) {
+      ESP_LOGW(TAG, "Requesting data from DHT failed!");
     } else {
-      delayMicroseconds(800);
+      ESP_LOGW(TAG, "Received only %u pulses from DHT!", bits);
     }
-    this->pin_->pin_mode(INPUT_PULLUP);
-    delayMicroseconds(40);
-
-    uint8_t bit = 7;
-    uint8_t byte = 0;
-
-    for (i = -1; i < 40; i++) {
-      uint32_t start_time = micros();
-
-      // Wait for rising edge
-      while (!this->pin_->digital_read()) {
-        if (micros() - start_time > 90) {
-          if (i < 0)
-            error_code = 1;
-          else
-            error_code = 2;
-          break;
-        }
-      }
-      if (error_code != 0)
-        break;
-
-      start_time = micros();
-      uint32_t end_time = start_time;
-
-      // Wait for falling edge
-      while (this->pin_->digital_read()) {
-        if ((end_time = micros()) - start_time > 90) {
-          if (i < 0)
-            error_code = 3;
-          else
-            error_code = 4;
-          break;
-        }
-      }
-      if (error_code != 0)
-        break;
-
-      if (i < 0)
-        continue;
-
-      if (end_time - start_time >= 40) {
-        data[byte] |= 1 << bit;
-      }
-      if (bit == 0) {
-        bit = 7;
-        byte++;
-      } else
-        bit--;
-    }
-  }
-  if (!report_errors && error_code != 0)
     return false;
+  }
 
-  switch (error_code) {
-    case 1:
-      ESP_LOGW(TAG, "Waiting for DHT communication to clear failed!");
-      return false;
-    case 2:
-      ESP_LOGW(TAG, "Rising edge for bit %d failed!", i);
-      return false;
-    case 3:
-      ESP_LOGW(TAG, "Requesting data from DHT failed!");
-      return false;
-    case 4:
-      ESP_LOGW(TAG, "Falling edge for bit %d failed!", i);
-      return false;
-    case 0:
-    default:
-      break;
+  // The pulses before the data bits are the host releasing the line and the sensor response.
+  const uint8_t *bit_lengths = lengths + bits - 40;
+  for (uint8_t i = 0; i < 40; i++) {
+    if (bit_lengths[i] >= 40)
+      data[i / 8] |= 1 << (7 - i % 8);
   }
 
   ESP_LOGVV(TAG,
@@ -3,9 +3,16 @@
 #include "esphome/core/component.h"
 #include "esphome/components/sensor/sensor.h"
 
+#ifdef ARDUINO_ARCH_ESP32
+#include <driver/rmt.h>
+#endif
+
 namespace esphome {
 namespace dht {
 
+/// Maximum amount of high pulses stored per read: host release, sensor response and 40 data bits.
+static const uint8_t DHT_MAX_PULSES = 48;
+
 enum DHTModel {
   DHT_MODEL_AUTO_DETECT = 0,
   DHT_MODEL_DHT11,
@@ -16,7 +23,25 @@ enum DHTModel {
   DHT_MODEL_DHT22_TYPE2
 };
 
-/// Component for reading temperature/humidity measurements from DHT11/DHT22 sensors.
+#ifdef ARDUINO_ARCH_ESP8266
+/// Records the length of every high pulse on the data line from a pin change interrupt.
+struct DHTPulseStore {
+  static void gpio_intr(DHTPulseStore *arg);
+
+  ISRInternalGPIOPin *isr_pin;
+  volatile uint32_t rise_time{0};
+  volatile bool high{false};
+  volatile uint8_t count{0};
+  /// High pulse lengths in µs, capped at 255.
+  volatile uint8_t pulses[DHT_MAX_PULSES];
+};
+#endif
+
+/** Component for reading temperature/humidity measurements from DHT11/DHT22 sensors.
+ *
+ * The pulse train of the sensor is captured in the background (with the RMT peripheral on the ESP32, with
+ * a pin change interrupt on the ESP8266) and decoded in loop(), so no interrupts are disabled during a read.
+ */
 class DHT : public PollingComponent {
  public:
   /** Manually select the DHT model.
@@ -43,19 +68,37 @@ class DHT : public PollingComponent {
   /// Set up the pins and check connection.
   void setup() override;
   void dump_config() override;
-  /// Update sensor values and push them to the frontend.
+  /// Start a read, the values are pushed to the frontend once the sensor has answered.
   void update() override;
+  /// Decode a finished capture.
+  void loop() override;
   /// HARDWARE_LATE setup priority.
   float get_setup_priority() const override;
 
  protected:
-  bool read_sensor_(float *temperature, float *humidity, bool report_errors);
+  /// Release the data line after the start signal and capture the answer of the sensor.
+  void start_capture_();
+  /// Once the capture is done, stop it and copy the high pulse lengths into pulses. Returns false while running.
+  bool finish_capture_(uint8_t *pulses, uint8_t *count);
+  void process_capture_(const uint8_t *pulses, uint8_t count);
+  bool read_sensor_(const uint8_t *pulses, uint8_t count, float *temperature, float *humidity, bool report_errors);
 
   GPIOPin *pin_;
   DHTModel model_{DHT_MODEL_AUTO_DETECT};
   bool is_auto_detect_{false};
   sensor::Sensor *temperature_sensor_{nullptr};
   sensor::Sensor *humidity_sensor_{nullptr};
+  bool reading_{false};
+  /// Whether this read is used to auto-detect the model and should not report errors.
+  bool detecting_{false};
+  uint32_t capture_started_{0};
+#ifdef ARDUINO_ARCH_ESP32
+  rmt_channel_t channel_;
+  RingbufHandle_t ringbuf_{nullptr};
+#endif
+#ifdef ARDUINO_ARCH_ESP8266
+  DHTPulseStore store_;
+#endif
 };
 
 }  // namespace dht
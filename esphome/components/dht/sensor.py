@@ -3,7 +3,8 @@ import esphome.config_validation as cv
 from esphome import pins
 from esphome.components import sensor
 from esphome.const import CONF_HUMIDITY, CONF_ID, CONF_MODEL, CONF_PIN, CONF_TEMPERATURE, \
-    ICON_THERMOMETER, UNIT_CELSIUS, ICON_WATER_PERCENT, UNIT_PERCENT
+    ICON_THERMOMETER, UNIT_CELSIUS, ICON_WATER_PERCENT, UNIT_PERCENT, CONF_MEMORY_BLOCKS, CONF_PLATFORM
+from esphome.core import CORE
 from esphome.cpp_helpers import gpio_pin_expression
 
 dht_ns = cg.esphome_ns.namespace('dht')
@@ -19,13 +20,44 @@ DHT_MODELS = {
 }
 DHT = dht_ns.class_('DHT', cg.PollingComponent)
 
-CONFIG_SCHEMA = cv.Schema({
+# The ESP32 has 8 RMT channels. remote_receiver and remote_transmitter take them from channel 0 upwards
+# (memory_blocks channels each), every DHT takes one from channel 7 downwards.
+RMT_CHANNELS = 8
+
+
+def _as_list(value):
+    if value is None:
+        return []
+    if isinstance(value, list):
+        return value
+    return [value]
+
+
+def validate_rmt_channels(config):
+    if not CORE.is_esp32:
+        return config
+    used = sum(1 for conf in _as_list(CORE.raw_config.get('sensor'))
+               if isinstance(conf, dict) and conf.get(CONF_PLATFORM) == 'dht')
+    for conf in _as_list(CORE.raw_config.get('remote_receiver')):
+        try:
+            used += int(conf.get(CONF_MEMORY_BLOCKS, 3))
+        except (AttributeError, TypeError, ValueError):
+            used += 3
+    used += len(_as_list(CORE.raw_config.get('remote_transmitter')))
+    if used > RMT_CHANNELS:
+        raise cv.Invalid(f"The DHT sensors, remote_receiver and remote_transmitter need {used} RMT channels, "
+                         f"but the ESP32 only has {RMT_CHANNELS}. Reduce the remote_receiver memory_blocks "
+                         f"or the number of DHT sensors.")
+    return config
+
+
+CONFIG_SCHEMA = cv.All(cv.Schema({
     cv.GenerateID(): cv.declare_id(DHT),
     cv.Required(CONF_PIN): pins.gpio_input_pin_schema,
     cv.Optional(CONF_TEMPERATURE): sensor.sensor_schema(UNIT_CELSIUS, ICON_THERMOMETER, 1),
     cv.Optional(CONF_HUMIDITY): sensor.sensor_schema(UNIT_PERCENT, ICON_WATER_PERCENT, 0),
     cv.Optional(CONF_MODEL, default='auto detect'): cv.enum(DHT_MODELS, upper=True, space='_'),
-}).extend(cv.polling_component_schema('60s'))
+}).extend(cv.polling_component_schema('60s')), validate_rmt_channels)
 
 
 def to_code(config):
@@ -2,19 +2,32 @@ import re
 import esphome.codegen as cg
 import esphome.config_validation as cv
 from esphome import automation
+from esphome.components import sensor
 from esphome.const import CONF_ID, ESP_PLATFORM_ESP32, CONF_INTERVAL, \
     CONF_DURATION, CONF_TRIGGER_ID, CONF_MAC_ADDRESS, CONF_SERVICE_UUID, CONF_MANUFACTURER_ID, \
     CONF_ON_BLE_ADVERTISE, CONF_ON_BLE_SERVICE_DATA_ADVERTISE, \
-    CONF_ON_BLE_MANUFACTURER_DATA_ADVERTISE
+    CONF_ON_BLE_MANUFACTURER_DATA_ADVERTISE, CONF_TIMEOUT, ICON_COUNTER, UNIT_EMPTY
 from esphome.core import coroutine
 
 ESP_PLATFORMS = [ESP_PLATFORM_ESP32]
-AUTO_LOAD = ['xiaomi_ble', 'ruuvi_ble']
 
 CONF_ESP32_BLE_ID = 'esp32_ble_id'
 CONF_SCAN_PARAMETERS = 'scan_parameters'
 CONF_WINDOW = 'window'
 CONF_ACTIVE = 'active'
+CONF_DUPLICATE_FILTER = 'duplicate_filter'
+CONF_CACHE_SIZE = 'cache_size'
+CONF_DUPLICATES = 'duplicates'
+
+
+def AUTO_LOAD(config):
+    # sensor is only needed for the duplicate filter's counter
+    duplicate_filter = (config or {}).get(CONF_DUPLICATE_FILTER) or {}
+    if isinstance(duplicate_filter, dict) and CONF_DUPLICATES in duplicate_filter:
+        return ['xiaomi_ble', 'ruuvi_ble', 'sensor']
+    return ['xiaomi_ble', 'ruuvi_ble']
+
+
 esp32_ble_tracker_ns = cg.esphome_ns.namespace('esp32_ble_tracker')
 ESP32BLETracker = esp32_ble_tracker_ns.class_('ESP32BLETracker', cg.Component)
 ESPBTDeviceListener = esp32_ble_tracker_ns.class_('ESPBTDeviceListener')
@@ -99,6 +112,11 @@ CONFIG_SCHEMA = cv.Schema({
         cv.Optional(CONF_WINDOW, default='30ms'): cv.positive_time_period_milliseconds,
         cv.Optional(CONF_ACTIVE, default=True): cv.boolean,
     }), validate_scan_parameters),
+    cv.Optional(CONF_DUPLICATE_FILTER): cv.Schema({
+        cv.Optional(CONF_TIMEOUT, default='10s'): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_CACHE_SIZE, default=32): cv.int_range(min=1, max=255),
+        cv.Optional(CONF_DUPLICATES): sensor.sensor_schema(UNIT_EMPTY, ICON_COUNTER, 0),
+    }),
     cv.Optional(CONF_ON_BLE_ADVERTISE): automation.validate_automation({
         cv.GenerateID(CONF_TRIGGER_ID): cv.declare_id(ESPBTAdvertiseTrigger),
         cv.Optional(CONF_MAC_ADDRESS): cv.mac_address,
@@ -131,6 +149,12 @@ def to_code(config):
     cg.add(var.set_scan_interval(int(params[CONF_INTERVAL].total_milliseconds / 0.625)))
     cg.add(var.set_scan_window(int(params[CONF_WINDOW].total_milliseconds / 0.625)))
     cg.add(var.set_scan_active(params[CONF_ACTIVE]))
+    if CONF_DUPLICATE_FILTER in config:
+        conf = config[CONF_DUPLICATE_FILTER]
+        cg.add(var.set_duplicate_filter(conf[CONF_TIMEOUT], conf[CONF_CACHE_SIZE]))
+        if CONF_DUPLICATES in conf:
+            sens = yield sensor.new_sensor(conf[CONF_DUPLICATES])
+            cg.add(var.set_duplicates_sensor(sens))
     for conf in config.get(CONF_ON_BLE_ADVERTISE, []):
         trigger = cg.new_Pvariable(conf[CONF_TRIGGER_ID], var)
         if CONF_MAC_ADDRESS in conf:
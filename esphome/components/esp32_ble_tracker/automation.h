@@ -12,6 +12,11 @@ class ESPBTAdvertiseTrigger : public Trigger<const ESPBTDevice &>, public ESPBTD
   explicit ESPBTAdvertiseTrigger(ESP32BLETracker *parent) { parent->register_listener(this); }
   void set_address(uint64_t address) { this->address_ = address; }
 
+  ESPBTListenerInterest get_interest() const override {
+    if (this->address_)
+      return ESPBTListenerInterest::for_address(this->address_);
+    return {};
+  }
   bool parse_device(const ESPBTDevice &device) override {
     if (this->address_ && device.address_uint64() != this->address_) {
       return false;
@@ -32,6 +37,11 @@ class BLEServiceDataAdvertiseTrigger : public Trigger<const adv_data_t &>, publi
   void set_service_uuid32(uint32_t uuid) { this->uuid_ = ESPBTUUID::from_uint32(uuid); }
   void set_service_uuid128(uint8_t *uuid) { this->uuid_ = ESPBTUUID::from_raw(uuid); }
 
+  ESPBTListenerInterest get_interest() const override {
+    if (this->address_)
+      return ESPBTListenerInterest::for_address(this->address_);
+    return ESPBTListenerInterest::for_service_uuid(this->uuid_);
+  }
   bool parse_device(const ESPBTDevice &device) override {
     if (this->address_ && device.address_uint64() != this->address_) {
       return false;
@@ -58,6 +68,11 @@ class BLEManufacturerDataAdvertiseTrigger : public Trigger<const adv_data_t &>,
   void set_manufacturer_uuid32(uint32_t uuid) { this->uuid_ = ESPBTUUID::from_uint32(uuid); }
   void set_manufacturer_uuid128(uint8_t *uuid) { this->uuid_ = ESPBTUUID::from_raw(uuid); }
 
+  ESPBTListenerInterest get_interest() const override {
+    if (this->address_)
+      return ESPBTListenerInterest::for_address(this->address_);
+    return ESPBTListenerInterest::for_manufacturer_id(this->uuid_);
+  }
   bool parse_device(const ESPBTDevice &device) override {
     if (this->address_ && device.address_uint64() != this->address_) {
       return false;
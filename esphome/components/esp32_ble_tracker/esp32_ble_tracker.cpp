@@ -12,6 +12,7 @@
 #include <freertos/task.h>
 #include <esp_gap_ble_api.h>
 #include <esp_bt_defs.h>
+#include <algorithm>
 
 // bt_trace.h
 #undef TAG
@@ -36,7 +37,6 @@ uint64_t ble_addr_to_uint64(const esp_bd_addr_t address) {
 
 void ESP32BLETracker::setup() {
   global_esp32_ble_tracker = this;
-  this->scan_result_lock_ = xSemaphoreCreateMutex();
   this->scan_end_lock_ = xSemaphoreCreateMutex();
 
   if (!ESP32BLETracker::ble_setup()) {
@@ -53,31 +53,35 @@ void ESP32BLETracker::loop() {
     global_esp32_ble_tracker->start_scan(false);
   }
 
-  if (xSemaphoreTake(this->scan_result_lock_, 5L / portTICK_PERIOD_MS)) {
-    uint32_t index = this->scan_result_index_;
-    xSemaphoreGive(this->scan_result_lock_);
+  if (!this->listeners_indexed_)
+    this->index_listeners_();
 
-    if (index >= 16) {
-      ESP_LOGW(TAG, "Too many BLE events to process. Some devices may not show up.");
+  size_t tail = this->scan_result_tail_.load(std::memory_order_relaxed);
+  const size_t head = this->scan_result_head_.load(std::memory_order_acquire);
+  for (; tail != head; tail++) {
+    const auto &param = this->scan_result_buffer_[tail % SCAN_RESULT_BUFFER_SIZE];
+    ESPBTKnownDevice &known = this->known_device_(ble_addr_to_uint64(param.bda));
+    known.last_seen = millis();
+    known.rssi = param.rssi;
+
+    if (this->duplicate_timeout_ != 0 && this->is_duplicate_(param)) {
+      this->scan_result_tail_.store(tail + 1, std::memory_order_release);
+      continue;
     }
-    for (size_t i = 0; i < index; i++) {
-      ESPBTDevice device;
-      device.parse_scan_rst(this->scan_result_buffer_[i]);
 
-      bool found = false;
-      for (auto *listener : this->listeners_)
-        if (listener->parse_device(device))
-          found = true;
+    ESPBTDevice &device = this->scan_device_;
+    device.parse_scan_rst(param);
+    // Parsed, the Bluetooth task may reuse the slot now
+    this->scan_result_tail_.store(tail + 1, std::memory_order_release);
 
-      if (!found) {
-        this->print_bt_device_info(device);
-      }
+    if (!this->dispatch_device_(device)) {
+      this->print_bt_device_info(device);
     }
+  }
 
-    if (xSemaphoreTake(this->scan_result_lock_, 10L / portTICK_PERIOD_MS)) {
-      this->scan_result_index_ = 0;
-      xSemaphoreGive(this->scan_result_lock_);
-    }
+  const uint32_t dropped = this->scan_results_dropped_.exchange(0);
+  if (dropped != 0) {
+    ESP_LOGW(TAG, "Too many BLE events to process, dropped %u. Some devices may not show up.", dropped);
   }
 
   if (this->scan_set_param_failed_) {
@@ -149,8 +153,28 @@ void ESP32BLETracker::start_scan(bool first) {
   if (!first) {
     for (auto *listener : this->listeners_)
       listener->on_scan_end();
+    ESP_LOGV(TAG, "Dispatched %u advertisements with %u parse_device() calls (%u without routing)",
+             this->advertisement_count_, this->dispatch_count_, this->advertisement_count_ * this->listeners_.size());
+    for (size_t i = 0; i < this->listeners_.size(); i++)
+      ESP_LOGV(TAG, "  Listener %u: %u calls", i, this->listeners_[i]->get_dispatch_count());
+  }
+  if (this->duplicate_timeout_ != 0) {
+    if (!first) {
+      ESP_LOGD(TAG, "Dropped %u duplicate advertisements, %u of %u addresses cached, %u evicted",
+               this->duplicates_dropped_, this->duplicate_cache_.size(), this->duplicate_cache_size_,
+               this->duplicate_cache_evictions_);
+#ifdef USE_SENSOR
+      if (this->duplicates_sensor_ != nullptr)
+        this->duplicates_sensor_->publish_state(this->duplicates_dropped_);
+#endif
+    }
+    // Let every device through at least once per scan, listeners like ble_presence rely on that
+    this->duplicate_cache_.clear();
+    this->duplicate_cache_.reserve(this->duplicate_cache_size_);
+    this->duplicates_dropped_ = 0;
+    this->duplicate_cache_evictions_ = 0;
   }
-  this->already_discovered_.clear();
+  this->known_devices_.clear();
   this->scan_params_.scan_type = this->scan_active_ ? BLE_SCAN_TYPE_ACTIVE : BLE_SCAN_TYPE_PASSIVE;
   this->scan_params_.own_addr_type = BLE_ADDR_TYPE_PUBLIC;
   this->scan_params_.scan_filter_policy = BLE_SCAN_FILTER_ALLOW_ALL;
@@ -192,12 +216,13 @@ void ESP32BLETracker::gap_scan_start_complete(const esp_ble_gap_cb_param_t::ble_
 
 void ESP32BLETracker::gap_scan_result(const esp_ble_gap_cb_param_t::ble_scan_result_evt_param &param) {
   if (param.search_evt == ESP_GAP_SEARCH_INQ_RES_EVT) {
-    if (xSemaphoreTake(this->scan_result_lock_, 0L)) {
-      if (this->scan_result_index_ < 16) {
-        this->scan_result_buffer_[this->scan_result_index_++] = param;
-      }
-      xSemaphoreGive(this->scan_result_lock_);
+    const size_t head = this->scan_result_head_.load(std::memory_order_relaxed);
+    if (head - this->scan_result_tail_.load(std::memory_order_acquire) >= SCAN_RESULT_BUFFER_SIZE) {
+      this->scan_results_dropped_++;
+      return;
     }
+    this->scan_result_buffer_[head % SCAN_RESULT_BUFFER_SIZE] = param;
+    this->scan_result_head_.store(head + 1, std::memory_order_release);
   } else if (param.search_evt == ESP_GAP_SEARCH_INQ_CMPL_EVT) {
     xSemaphoreGive(this->scan_end_lock_);
   }
@@ -320,6 +345,11 @@ void ESPBTDevice::parse_scan_rst(const esp_ble_gap_cb_param_t::ble_scan_result_e
     this->address_[i] = param.bda[i];
   this->address_type_ = param.ble_addr_type;
   this->rssi_ = param.rssi;
+  this->name_.clear();
+  this->tx_powers_.clear();
+  this->appearance_.reset();
+  this->ad_flag_.reset();
+  this->service_uuids_.clear();
   this->parse_adv_(param);
 
 #ifdef ESPHOME_LOG_HAS_VERY_VERBOSE
@@ -368,7 +398,14 @@ void ESPBTDevice::parse_scan_rst(const esp_ble_gap_cb_param_t::ble_scan_result_e
   ESP_LOGVV(TAG, "Adv data: %s", hexencode(param.ble_adv, param.adv_data_len + param.scan_rsp_len).c_str());
 #endif
 }
+ServiceData &ESPBTDevice::next_service_data_(std::vector<ServiceData> &datas, size_t &count) {
+  if (count == datas.size())
+    datas.emplace_back();
+  return datas[count++];
+}
 void ESPBTDevice::parse_adv_(const esp_ble_gap_cb_param_t::ble_scan_result_evt_param &param) {
+  size_t manufacturer_data_count = 0;
+  size_t service_data_count = 0;
   size_t offset = 0;
   const uint8_t *payload = param.ble_adv;
   uint8_t len = param.adv_data_len + param.scan_rsp_len;
@@ -395,7 +432,7 @@ void ESPBTDevice::parse_adv_(const esp_ble_gap_cb_param_t::ble_scan_result_evt_p
         // CSS 1.2 LOCAL NAME
         // "The Local Name data type shall be the same as, or a shortened version of, the local name assigned to the
         // device." CSS 1: Optional in this context; shall not appear more than once in a block.
-        this->name_ = std::string(reinterpret_cast<const char *>(record), record_length);
+        this->name_.assign(reinterpret_cast<const char *>(record), record_length);
         break;
       }
       case ESP_BLE_AD_TYPE_TX_PWR: {
@@ -459,10 +496,9 @@ void ESPBTDevice::parse_adv_(const esp_ble_gap_cb_param_t::ble_scan_result_evt_p
           ESP_LOGV(TAG, "Record length too small for ESP_BLE_AD_MANUFACTURER_SPECIFIC_TYPE");
           break;
         }
-        ServiceData data{};
+        ServiceData &data = next_service_data_(this->manufacturer_datas_, manufacturer_data_count);
         data.uuid = ESPBTUUID::from_uint16(*reinterpret_cast<const uint16_t *>(record));
         data.data.assign(record + 2UL, record + record_length);
-        this->manufacturer_datas_.push_back(data);
         break;
       }
 
@@ -477,10 +513,9 @@ void ESPBTDevice::parse_adv_(const esp_ble_gap_cb_param_t::ble_scan_result_evt_p
           ESP_LOGV(TAG, "Record length too small for ESP_BLE_AD_TYPE_SERVICE_DATA");
           break;
         }
-        ServiceData data{};
+        ServiceData &data = next_service_data_(this->service_datas_, service_data_count);
         data.uuid = ESPBTUUID::from_uint16(*reinterpret_cast<const uint16_t *>(record));
         data.data.assign(record + 2UL, record + record_length);
-        this->service_datas_.push_back(data);
         break;
       }
       case ESP_BLE_AD_TYPE_32SERVICE_DATA: {
@@ -491,10 +526,9 @@ void ESPBTDevice::parse_adv_(const esp_ble_gap_cb_param_t::ble_scan_result_evt_p
           ESP_LOGV(TAG, "Record length too small for ESP_BLE_AD_TYPE_32SERVICE_DATA");
           break;
         }
-        ServiceData data{};
+        ServiceData &data = next_service_data_(this->service_datas_, service_data_count);
         data.uuid = ESPBTUUID::from_uint32(*reinterpret_cast<const uint32_t *>(record));
         data.data.assign(record + 4UL, record + record_length);
-        this->service_datas_.push_back(data);
         break;
       }
       case ESP_BLE_AD_TYPE_128SERVICE_DATA: {
@@ -505,10 +539,9 @@ void ESPBTDevice::parse_adv_(const esp_ble_gap_cb_param_t::ble_scan_result_evt_p
           ESP_LOGV(TAG, "Record length too small for ESP_BLE_AD_TYPE_128SERVICE_DATA");
           break;
         }
-        ServiceData data{};
+        ServiceData &data = next_service_data_(this->service_datas_, service_data_count);
         data.uuid = ESPBTUUID::from_raw(record);
         data.data.assign(record + 16UL, record + record_length);
-        this->service_datas_.push_back(data);
         break;
       }
       default: {
@@ -517,6 +550,10 @@ void ESPBTDevice::parse_adv_(const esp_ble_gap_cb_param_t::ble_scan_result_evt_p
       }
     }
   }
+
+  // Drop slots left over from previous advertisements
+  this->manufacturer_datas_.resize(manufacturer_data_count);
+  this->service_datas_.resize(service_data_count);
 }
 std::string ESPBTDevice::address_str() const {
   char mac[24];
@@ -533,13 +570,149 @@ void ESP32BLETracker::dump_config() {
   ESP_LOGCONFIG(TAG, "  Scan Window: %.1f ms", this->scan_window_ * 0.625f);
   ESP_LOGCONFIG(TAG, "  Scan Type: %s", this->scan_active_ ? "ACTIVE" : "PASSIVE");
 }
-void ESP32BLETracker::print_bt_device_info(const ESPBTDevice &device) {
+static bool known_device_before(const ESPBTKnownDevice &device, uint64_t address) {
+  return device.address < address;
+}
+ESPBTKnownDevice &ESP32BLETracker::known_device_(uint64_t address) {
+  auto it = std::lower_bound(this->known_devices_.begin(), this->known_devices_.end(), address, known_device_before);
+  if (it == this->known_devices_.end() || it->address != address)
+    it = this->known_devices_.insert(it, ESPBTKnownDevice{address, 0, 0, false});
+  return *it;
+}
+const ESPBTKnownDevice *ESP32BLETracker::get_known_device(uint64_t address) const {
+  auto it = std::lower_bound(this->known_devices_.begin(), this->known_devices_.end(), address, known_device_before);
+  if (it == this->known_devices_.end() || it->address != address)
+    return nullptr;
+  return &*it;
+}
+ESPBTListenerInterest ESPBTListenerInterest::for_address(uint64_t address) {
+  ESPBTListenerInterest interest;
+  interest.type = ADDRESS;
+  interest.address = address;
+  return interest;
+}
+ESPBTListenerInterest ESPBTListenerInterest::for_service_uuid(const ESPBTUUID &uuid) {
+  ESPBTListenerInterest interest;
+  interest.type = SERVICE_UUID;
+  interest.uuid = uuid;
+  return interest;
+}
+ESPBTListenerInterest ESPBTListenerInterest::for_manufacturer_id(const ESPBTUUID &manufacturer_id) {
+  ESPBTListenerInterest interest;
+  interest.type = MANUFACTURER_ID;
+  interest.uuid = manufacturer_id;
+  return interest;
+}
+bool ESP32BLETracker::is_duplicate_(const esp_ble_gap_cb_param_t::ble_scan_result_evt_param &param) {
+  const uint64_t address = ble_addr_to_uint64(param.bda);
+  const uint32_t hash = fnv1_hash(param.ble_adv, param.adv_data_len + param.scan_rsp_len);
+  const uint32_t now = millis();
+
+  ESPBTDuplicateEntry *oldest = nullptr;
+  for (auto &entry : this->duplicate_cache_) {
+    if (entry.address == address) {
+      entry.last_used = now;
+      if (entry.hash == hash && now - entry.passed_at < this->duplicate_timeout_) {
+        this->duplicates_dropped_++;
+        return true;
+      }
+      entry.hash = hash;
+      entry.passed_at = now;
+      return false;
+    }
+    if (oldest == nullptr || now - entry.last_used > now - oldest->last_used)
+      oldest = &entry;
+  }
+
+  const ESPBTDuplicateEntry entry{address, hash, now, now};
+  if (this->duplicate_cache_.size() < this->duplicate_cache_size_) {
+    this->duplicate_cache_.push_back(entry);
+  } else if (oldest != nullptr) {
+    *oldest = entry;
+    this->duplicate_cache_evictions_++;
+  }
+  return false;
+}
+void ESP32BLETracker::index_listeners_() {
+  this->any_listeners_.clear();
+  this->address_listeners_.clear();
+  this->service_uuid_listeners_.clear();
+  this->manufacturer_id_listeners_.clear();
+  for (auto *listener : this->listeners_) {
+    const ESPBTListenerInterest interest = listener->get_interest();
+    switch (interest.type) {
+      case ESPBTListenerInterest::ADDRESS:
+        this->address_listeners_.emplace_back(interest.address, listener);
+        break;
+      case ESPBTListenerInterest::SERVICE_UUID:
+        this->service_uuid_listeners_.emplace_back(interest.uuid, listener);
+        break;
+      case ESPBTListenerInterest::MANUFACTURER_ID:
+        this->manufacturer_id_listeners_.emplace_back(interest.uuid, listener);
+        break;
+      case ESPBTListenerInterest::ANY:
+      default:
+        this->any_listeners_.push_back(listener);
+        break;
+    }
+  }
+  // Stable so that listeners for the same address keep their registration order
+  std::stable_sort(this->address_listeners_.begin(), this->address_listeners_.end(),
+                   [](const std::pair<uint64_t, ESPBTDeviceListener *> &a,
+                      const std::pair<uint64_t, ESPBTDeviceListener *> &b) { return a.first < b.first; });
+  this->listeners_indexed_ = true;
+}
+bool ESP32BLETracker::dispatch_(ESPBTDeviceListener *listener, const ESPBTDevice &device) {
+  if (listener->last_dispatch_ == this->advertisement_count_)
+    // Already matched this advertisement through another key
+    return false;
+  listener->last_dispatch_ = this->advertisement_count_;
+  listener->dispatch_count_++;
+  this->dispatch_count_++;
+  return listener->parse_device(device);
+}
+bool ESP32BLETracker::dispatch_device_(const ESPBTDevice &device) {
+  this->advertisement_count_++;
+  if (this->advertisement_count_ == 0)
+    // 0 is the initial last_dispatch_ of every listener
+    this->advertisement_count_++;
+
+  bool found = false;
+  for (auto *listener : this->any_listeners_)
+    if (this->dispatch_(listener, device))
+      found = true;
+
   const uint64_t address = device.address_uint64();
-  for (auto &disc : this->already_discovered_) {
-    if (disc == address)
-      return;
+  auto it = std::lower_bound(
+      this->address_listeners_.begin(), this->address_listeners_.end(), address,
+      [](const std::pair<uint64_t, ESPBTDeviceListener *> &entry, uint64_t value) { return entry.first < value; });
+  for (; it != this->address_listeners_.end() && it->first == address; it++)
+    if (this->dispatch_(it->second, device))
+      found = true;
+
+  if (!this->service_uuid_listeners_.empty()) {
+    for (auto &uuid : device.get_service_uuids())
+      for (auto &entry : this->service_uuid_listeners_)
+        if (entry.first == uuid && this->dispatch_(entry.second, device))
+          found = true;
+    for (auto &service_data : device.get_service_datas())
+      for (auto &entry : this->service_uuid_listeners_)
+        if (entry.first == service_data.uuid && this->dispatch_(entry.second, device))
+          found = true;
   }
-  this->already_discovered_.push_back(address);
+
+  for (auto &manufacturer_data : device.get_manufacturer_datas())
+    for (auto &entry : this->manufacturer_id_listeners_)
+      if (entry.first == manufacturer_data.uuid && this->dispatch_(entry.second, device))
+        found = true;
+
+  return found;
+}
+void ESP32BLETracker::print_bt_device_info(const ESPBTDevice &device) {
+  ESPBTKnownDevice &known = this->known_device_(device.address_uint64());
+  if (known.printed)
+    return;
+  known.printed = true;
 
   ESP_LOGD(TAG, "Found device %s RSSI=%d", device.address_str().c_str(), device.get_rssi());
 
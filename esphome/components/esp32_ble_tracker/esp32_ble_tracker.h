@@ -2,11 +2,17 @@
 
 #include "esphome/core/component.h"
 #include "esphome/core/helpers.h"
+#include "esphome/core/defines.h"
+
+#ifdef USE_SENSOR
+#include "esphome/components/sensor/sensor.h"
+#endif
 
 #ifdef ARDUINO_ARCH_ESP32
 
 #include <string>
 #include <array>
+#include <atomic>
 #include <esp_gap_ble_api.h>
 #include <esp_bt_defs.h>
 
@@ -68,6 +74,11 @@ class ESPBLEiBeacon {
 
 class ESPBTDevice {
  public:
+  /** Parse a scan result into this device.
+   *
+   * All previous data is replaced, the containers keep their memory so that reusing one device for
+   * every advertisement doesn't allocate once they have grown to the usual advertisement sizes.
+   */
   void parse_scan_rst(const esp_ble_gap_cb_param_t::ble_scan_result_evt_param &param);
 
   std::string address_str() const;
@@ -105,6 +116,8 @@ class ESPBTDevice {
 
  protected:
   void parse_adv_(const esp_ble_gap_cb_param_t::ble_scan_result_evt_param &param);
+  /// Get the next service data slot in datas, reusing a slot (and its data buffer) left over from a previous parse.
+  static ServiceData &next_service_data_(std::vector<ServiceData> &datas, size_t &count);
 
   esp_bd_addr_t address_{
       0,
@@ -122,22 +135,92 @@ class ESPBTDevice {
 
 class ESP32BLETracker;
 
+/** Which advertisements a listener wants to receive.
+ *
+ * ESP32BLETracker indexes its listeners by their interest and only passes an advertisement to the listeners
+ * interested in it. This is a pre-filter only, parse_device() still has to check the device itself.
+ */
+struct ESPBTListenerInterest {
+  enum Type {
+    /// Every advertisement.
+    ANY,
+    /// Advertisements from one MAC address.
+    ADDRESS,
+    /// Advertisements listing a service UUID or carrying service data for it.
+    SERVICE_UUID,
+    /// Advertisements carrying manufacturer data for a manufacturer ID.
+    MANUFACTURER_ID,
+  } type{ANY};
+  uint64_t address{0};
+  /// The service UUID or manufacturer ID.
+  ESPBTUUID uuid{};
+
+  static ESPBTListenerInterest for_address(uint64_t address);
+  static ESPBTListenerInterest for_service_uuid(const ESPBTUUID &uuid);
+  static ESPBTListenerInterest for_manufacturer_id(const ESPBTUUID &manufacturer_id);
+};
+
 class ESPBTDeviceListener {
  public:
   virtual void on_scan_end() {}
   virtual bool parse_device(const ESPBTDevice &device) = 0;
+  /// The advertisements this listener wants, queried once when the tracker builds its listener index.
+  virtual ESPBTListenerInterest get_interest() const { return {}; }
   void set_parent(ESP32BLETracker *parent) { parent_ = parent; }
+  /// Number of advertisements passed to parse_device().
+  uint32_t get_dispatch_count() const { return this->dispatch_count_; }
 
  protected:
+  friend ESP32BLETracker;
+
   ESP32BLETracker *parent_{nullptr};
+  uint32_t dispatch_count_{0};
+  /// Sequence number of the last advertisement passed to this listener, so it is called at most once for each.
+  uint32_t last_dispatch_{0};
+};
+
+/// A device seen during the current scan.
+struct ESPBTKnownDevice {
+  uint64_t address;
+  /// millis() timestamp of the last advertisement.
+  uint32_t last_seen;
+  int8_t rssi;
+  /// Whether print_bt_device_info() has already logged this device.
+  bool printed;
 };
 
+/// An address in the duplicate advertisement filter.
+struct ESPBTDuplicateEntry {
+  uint64_t address;
+  /// Hash of the last advertisement and scan response data passed on for this address.
+  uint32_t hash;
+  /// millis() timestamp of when that payload was passed on.
+  uint32_t passed_at;
+  /// millis() timestamp of the last advertisement from this address, for least recently used eviction.
+  uint32_t last_used;
+};
+
+/// Number of scan results that can be queued between the Bluetooth task and the main loop.
+static const size_t SCAN_RESULT_BUFFER_SIZE = 32;
+
 class ESP32BLETracker : public Component {
  public:
   void set_scan_duration(uint32_t scan_duration) { scan_duration_ = scan_duration; }
   void set_scan_interval(uint32_t scan_interval) { scan_interval_ = scan_interval; }
   void set_scan_window(uint32_t scan_window) { scan_window_ = scan_window; }
   void set_scan_active(bool scan_active) { scan_active_ = scan_active; }
+  /** Drop advertisements repeating the last payload of their address within timeout (in ms).
+   *
+   * At most cache_size addresses are remembered, the least recently seen address is evicted first.
+   */
+  void set_duplicate_filter(uint32_t timeout, size_t cache_size) {
+    this->duplicate_timeout_ = timeout;
+    this->duplicate_cache_size_ = cache_size;
+  }
+  /// Sensor publishing the number of duplicate advertisements dropped during the last scan.
+#ifdef USE_SENSOR
+  void set_duplicates_sensor(sensor::Sensor *duplicates_sensor) { this->duplicates_sensor_ = duplicates_sensor; }
+#endif
 
   /// Setup the FreeRTOS task and the Bluetooth stack.
   void setup() override;
@@ -148,10 +231,18 @@ class ESP32BLETracker : public Component {
   void register_listener(ESPBTDeviceListener *listener) {
     listener->set_parent(this);
     this->listeners_.push_back(listener);
+    this->listeners_indexed_ = false;
   }
 
   void print_bt_device_info(const ESPBTDevice &device);
 
+  /// Get the device with the given address if it has been seen during the current scan.
+  const ESPBTKnownDevice *get_known_device(uint64_t address) const;
+  /// Number of advertisements received since boot.
+  uint32_t get_advertisement_count() const { return this->advertisement_count_; }
+  /// Number of parse_device() calls over all listeners since boot.
+  uint32_t get_dispatch_count() const { return this->dispatch_count_; }
+
  protected:
   /// The FreeRTOS task managing the bluetooth interface.
   static bool ble_setup();
@@ -165,10 +256,40 @@ class ESP32BLETracker : public Component {
   void gap_scan_set_param_complete(const esp_ble_gap_cb_param_t::ble_scan_param_cmpl_evt_param &param);
   /// Called when a `ESP_GAP_BLE_SCAN_START_COMPLETE_EVT` event is received.
   void gap_scan_start_complete(const esp_ble_gap_cb_param_t::ble_scan_start_cmpl_evt_param &param);
-
-  /// Vector of addresses that have already been printed in print_bt_device_info
-  std::vector<uint64_t> already_discovered_;
+  /// Find or add the known device entry for address.
+  ESPBTKnownDevice &known_device_(uint64_t address);
+  /// Whether a scan result repeats its address's last payload within duplicate_timeout_.
+  bool is_duplicate_(const esp_ble_gap_cb_param_t::ble_scan_result_evt_param &param);
+  /// Sort the listeners into the index vectors below by their interest.
+  void index_listeners_();
+  /// Pass a device to every listener interested in it, returns whether any listener handled it.
+  bool dispatch_device_(const ESPBTDevice &device);
+  bool dispatch_(ESPBTDeviceListener *listener, const ESPBTDevice &device);
+
+  /// Devices seen during the current scan, sorted by address.
+  std::vector<ESPBTKnownDevice> known_devices_;
   std::vector<ESPBTDeviceListener *> listeners_;
+  bool listeners_indexed_{false};
+  /// Listeners without an interest, called for every advertisement.
+  std::vector<ESPBTDeviceListener *> any_listeners_;
+  /// Listeners interested in an address, sorted by address.
+  std::vector<std::pair<uint64_t, ESPBTDeviceListener *>> address_listeners_;
+  std::vector<std::pair<ESPBTUUID, ESPBTDeviceListener *>> service_uuid_listeners_;
+  std::vector<std::pair<ESPBTUUID, ESPBTDeviceListener *>> manufacturer_id_listeners_;
+  /// Number of advertisements dispatched, also the sequence number of the current advertisement.
+  uint32_t advertisement_count_{0};
+  /// Number of parse_device() calls over all listeners.
+  uint32_t dispatch_count_{0};
+  /// Duplicate filter timeout in ms, 0 if the filter is disabled.
+  uint32_t duplicate_timeout_{0};
+  size_t duplicate_cache_size_{0};
+  std::vector<ESPBTDuplicateEntry> duplicate_cache_;
+  /// Counters for the current scan.
+  uint32_t duplicates_dropped_{0};
+  uint32_t duplicate_cache_evictions_{0};
+#ifdef USE_SENSOR
+  sensor::Sensor *duplicates_sensor_{nullptr};
+#endif
   /// A structure holding the ESP BLE scan parameters.
   esp_ble_scan_params_t scan_params_;
   /// The interval in seconds to perform scans.
@@ -176,10 +297,17 @@ class ESP32BLETracker : public Component {
   uint32_t scan_interval_;
   uint32_t scan_window_;
   bool scan_active_;
-  SemaphoreHandle_t scan_result_lock_;
   SemaphoreHandle_t scan_end_lock_;
-  size_t scan_result_index_{0};
-  esp_ble_gap_cb_param_t::ble_scan_result_evt_param scan_result_buffer_[16];
+  /** Single-producer single-consumer ring of scan results: the Bluetooth task only advances the head,
+   * loop() only advances the tail. A slot is only handed back to the Bluetooth task once loop() is done with it,
+   * so results are parsed in place.
+   */
+  esp_ble_gap_cb_param_t::ble_scan_result_evt_param scan_result_buffer_[SCAN_RESULT_BUFFER_SIZE];
+  std::atomic<size_t> scan_result_head_{0};
+  std::atomic<size_t> scan_result_tail_{0};
+  std::atomic<uint32_t> scan_results_dropped_{0};
+  /// Reused for every scan result, so parsing doesn't allocate in the steady state.
+  ESPBTDevice scan_device_;
   esp_bt_status_t scan_start_failed_{ESP_BT_STATUS_SUCCESS};
   esp_bt_status_t scan_set_param_failed_{ESP_BT_STATUS_SUCCESS};
 };
@@ -10,6 +10,9 @@ I2CComponent = i2c_ns.class_('I2CComponent', cg.Component)
 I2CDevice = i2c_ns.class_('I2CDevice')
 
 MULTI_CONF = True
+CONF_BATCH_WINDOW = 'batch_window'
+CONF_STATS_INTERVAL = 'stats_interval'
+
 CONFIG_SCHEMA = cv.Schema({
     cv.GenerateID(): cv.declare_id(I2CComponent),
     cv.Optional(CONF_SDA, default='SDA'): pins.input_pin,
@@ -17,6 +20,8 @@ CONFIG_SCHEMA = cv.Schema({
     cv.Optional(CONF_FREQUENCY, default='50kHz'):
         cv.All(cv.frequency, cv.Range(min=0, min_included=False)),
     cv.Optional(CONF_SCAN, default=True): cv.boolean,
+    cv.Optional(CONF_BATCH_WINDOW): cv.positive_time_period_milliseconds,
+    cv.Optional(CONF_STATS_INTERVAL): cv.positive_time_period_milliseconds,
 }).extend(cv.COMPONENT_SCHEMA)
 
 
@@ -30,6 +35,10 @@ def to_code(config):
     cg.add(var.set_scl_pin(config[CONF_SCL]))
     cg.add(var.set_frequency(int(config[CONF_FREQUENCY])))
     cg.add(var.set_scan(config[CONF_SCAN]))
+    if CONF_BATCH_WINDOW in config:
+        cg.add(var.set_batch_window(config[CONF_BATCH_WINDOW]))
+    if CONF_STATS_INTERVAL in config:
+        cg.add(var.set_stats_interval(config[CONF_STATS_INTERVAL]))
     cg.add_library('Wire', None)
 
 
@@ -1,4 +1,5 @@
 #include "i2c.h"
+#include <algorithm>
 #include "esphome/core/log.h"
 #include "esphome/core/helpers.h"
 #include "esphome/core/application.h"
@@ -23,12 +24,16 @@ I2CComponent::I2CComponent() {
 void I2CComponent::setup() {
   this->wire_->begin(this->sda_pin_, this->scl_pin_);
   this->wire_->setClock(this->frequency_);
+  if (this->stats_interval_ != 0)
+    this->set_interval("stats", this->stats_interval_, [this]() { this->log_stats_(); });
 }
 void I2CComponent::dump_config() {
   ESP_LOGCONFIG(TAG, "I2C Bus:");
   ESP_LOGCONFIG(TAG, "  SDA Pin: GPIO%u", this->sda_pin_);
   ESP_LOGCONFIG(TAG, "  SCL Pin: GPIO%u", this->scl_pin_);
   ESP_LOGCONFIG(TAG, "  Frequency: %u Hz", this->frequency_);
+  if (this->batch_window_ != 0)
+    ESP_LOGCONFIG(TAG, "  Batch Window: %u ms", this->batch_window_);
   if (this->scan_) {
     ESP_LOGI(TAG, "Scanning i2c bus for active devices...");
     uint8_t found = 0;
@@ -52,12 +57,125 @@ void I2CComponent::dump_config() {
 }
 float I2CComponent::get_setup_priority() const { return setup_priority::BUS; }
 
+bool I2CComponent::transaction(uint8_t address, const uint8_t *write_data, uint8_t write_len, uint32_t conversion,
+                               uint8_t read_len, i2c_transaction_callback_t &&callback) {
+  if (write_len > I2C_TRANSACTION_BUFFER_SIZE || read_len > I2C_TRANSACTION_BUFFER_SIZE) {
+    ESP_LOGW(TAG, "Transaction to 0x%02X is too large!", address);
+    return false;
+  }
+  I2CTransaction t{};
+  t.address = address;
+  t.write_len = write_len;
+  t.read_len = read_len;
+  t.waiting = false;
+  t.conversion = conversion;
+  t.started_at = 0;
+  if (write_len != 0)
+    memcpy(t.data.data(), write_data, write_len);
+  t.callback = std::move(callback);
+  if (this->transactions_.empty() && !this->batch_running_)
+    this->batch_started_ = millis();
+  this->transactions_.push_back(std::move(t));
+  return true;
+}
+void I2CComponent::loop() {
+  if (this->transactions_.empty()) {
+    this->batch_running_ = false;
+    return;
+  }
+  const uint32_t now = millis();
+  if (!this->batch_running_) {
+    // Give other devices the chance to join this batch before touching the bus.
+    if (now - this->batch_started_ < this->batch_window_)
+      return;
+    this->batch_running_ = true;
+  }
+  // Transactions queued by callbacks during this loop are started on the next one.
+  size_t end = this->transactions_.size();
+  size_t i = 0;
+  while (i < end) {
+    I2CTransaction &t = this->transactions_[i];
+    if (!t.waiting) {
+      // Only one transaction per device may be in flight, later ones wait for the earlier ones to finish.
+      bool busy = false;
+      for (size_t j = 0; j < i; j++) {
+        if (this->transactions_[j].address == t.address) {
+          busy = true;
+          break;
+        }
+      }
+      if (busy) {
+        i++;
+        continue;
+      }
+
+      bool ok = t.write_len == 0 || this->write_bytes_raw(t.address, t.data.data(), t.write_len);
+      if (!ok || t.read_len == 0) {
+        this->finish_transaction_(i, ok);
+        end--;
+        continue;
+      }
+      t.waiting = true;
+      t.started_at = now;
+    }
+
+    if (now - t.started_at < t.conversion) {
+      i++;
+      continue;
+    }
+    bool ok = this->raw_receive(t.address, t.data.data(), t.read_len);
+    this->finish_transaction_(i, ok);
+    end--;
+  }
+}
+void I2CComponent::finish_transaction_(size_t index, bool success) {
+  // Move the transaction out first, the callback may queue new transactions.
+  I2CTransaction t = std::move(this->transactions_[index]);
+  this->transactions_.erase(this->transactions_.begin() + index);
+  t.callback(success, t.data.data(), success ? t.read_len : 0);
+}
+
+I2CDeviceStats &I2CComponent::get_stats_(uint8_t address) {
+  auto it = std::lower_bound(this->device_stats_.begin(), this->device_stats_.end(), address,
+                             [](const I2CDeviceStats &stats, uint8_t address) { return stats.address < address; });
+  if (it == this->device_stats_.end() || it->address != address) {
+    I2CDeviceStats stats{};
+    stats.address = address;
+    it = this->device_stats_.insert(it, stats);
+  }
+  return *it;
+}
+void I2CComponent::record_transfer_(uint8_t address, bool success, uint32_t started_at) {
+  I2CDeviceStats &stats = this->get_stats_(address);
+  stats.transfers++;
+  if (!success)
+    stats.errors++;
+  stats.bus_time_us += micros() - started_at;
+}
+void I2CComponent::log_stats_() {
+  for (auto &stats : this->device_stats_) {
+    if (stats.transfers == 0)
+      continue;
+    ESP_LOGD(TAG, "0x%02X: %u transfers, %u errors, %u us bus time", stats.address, stats.transfers, stats.errors,
+             stats.bus_time_us);
+    stats.transfers = 0;
+    stats.errors = 0;
+    stats.bus_time_us = 0;
+  }
+}
+
 void I2CComponent::raw_begin_transmission(uint8_t address) {
   ESP_LOGVV(TAG, "Beginning Transmission to 0x%02X:", address);
   this->wire_->beginTransmission(address);
 }
 bool I2CComponent::raw_end_transmission(uint8_t address) {
+  // Wire only buffers the written bytes, the transfer itself happens in endTransmission.
+  // Only time and count transfers if the stats are logged, this runs for every transfer on the bus.
+  const bool record = this->stats_interval_ != 0;
+  const uint32_t started_at = record ? micros() : 0;
   uint8_t status = this->wire_->endTransmission();
+  if (record)
+    this->record_transfer_(address, status == 0, started_at);
   ESP_LOGVV(TAG, "    Transmission ended. Status code: 0x%02X", status);
 
   switch (status) {
@@ -81,7 +199,11 @@ bool I2CComponent::raw_end_transmission(uint8_t address) {
 }
 bool I2CComponent::raw_request_from(uint8_t address, uint8_t len) {
   ESP_LOGVV(TAG, "Requesting %u bytes from 0x%02X:", len, address);
+  const bool record = this->stats_interval_ != 0;
+  const uint32_t started_at = record ? micros() : 0;
   uint8_t ret = this->wire_->requestFrom(address, len);
+  if (record)
+    this->record_transfer_(address, ret == len, started_at);
   if (ret != len) {
     ESP_LOGW(TAG, "Requesting %u bytes from 0x%02X failed!", len, address);
     return false;
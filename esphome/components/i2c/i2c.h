@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <Wire.h>
 #include "esphome/core/component.h"
 #include "esphome/core/helpers.h"
@@ -9,6 +10,36 @@ namespace i2c {
 
 #define LOG_I2C_DEVICE(this) ESP_LOGCONFIG(TAG, "  Address: 0x%02X", this->address_);
 
+/// Maximum amount of bytes a single queued transaction can write or read.
+static const uint8_t I2C_TRANSACTION_BUFFER_SIZE = 32;
+
+/// Called once a queued transaction has finished, data is only valid for the duration of the call.
+using i2c_transaction_callback_t = std::function<void(bool success, const uint8_t *data, uint8_t len)>;
+
+/// Bus usage counters for a single device address, see I2CComponent::set_stats_interval.
+struct I2CDeviceStats {
+  uint8_t address;
+  /// Amount of write or read transfers to this address.
+  uint32_t transfers;
+  /// Amount of transfers that failed (NACK, short read, ...).
+  uint32_t errors;
+  /// Total time in µs this address occupied the bus.
+  uint32_t bus_time_us;
+};
+
+/// A queued "write command, wait for the conversion, read the result" job, see I2CComponent::transaction.
+struct I2CTransaction {
+  uint8_t address;
+  uint8_t write_len;
+  uint8_t read_len;
+  /// Whether the write has been done and the transaction is waiting for the conversion to finish.
+  bool waiting;
+  uint32_t conversion;
+  uint32_t started_at;
+  std::array<uint8_t, I2C_TRANSACTION_BUFFER_SIZE> data;
+  i2c_transaction_callback_t callback;
+};
+
 /** The I2CComponent is the base of ESPHome's i2c communication.
  *
  * It handles setting up the bus (with pins, clock frequency) and provides nice helper functions to
@@ -30,6 +61,15 @@ class I2CComponent : public Component {
   void set_scl_pin(uint8_t scl_pin) { scl_pin_ = scl_pin; }
   void set_frequency(uint32_t frequency) { frequency_ = frequency; }
   void set_scan(bool scan) { scan_ = scan; }
+  /** Hold transactions queued while the bus is idle for this many ms, so that devices updating at
+   * slightly different times are started together and their conversion times overlap. 0 disables batching.
+   */
+  void set_batch_window(uint32_t batch_window) { batch_window_ = batch_window; }
+  /// Log (and reset) the per-device bus usage counters every stats_interval ms. 0 disables logging.
+  void set_stats_interval(uint32_t stats_interval) { stats_interval_ = stats_interval; }
+
+  /// Bus usage counters per device address, sorted by address.
+  const std::vector<I2CDeviceStats> &get_device_stats() const { return this->device_stats_; }
 
   /** Read len amount of bytes from a register into data. Optionally with a conversion time after
    * writing the register value to the bus.
@@ -88,6 +128,23 @@ class I2CComponent : public Component {
   /// Write a single 16-bit word of data into the specified register of address. Return true if successful.
   bool write_byte_16(uint8_t address, uint8_t a_register, uint16_t data);
 
+  /** Queue a transaction that writes write_len bytes, waits conversion ms and then reads read_len bytes,
+   * without blocking the main loop.
+   *
+   * Transactions are run by the bus in loop() in the order they were submitted. Transactions to the same
+   * address never overlap, while the conversion time of one device can pass while others use the bus.
+   *
+   * @param address The address to use for the transaction.
+   * @param write_data The bytes to write at the start of the transaction (typically a register or command).
+   * @param write_len The amount of bytes to write, 0 to only read.
+   * @param conversion The time in ms between the write and the read.
+   * @param read_len The amount of bytes to read, 0 to only write.
+   * @param callback Called with the result once the transaction has finished or failed.
+   * @return If the transaction could be queued.
+   */
+  bool transaction(uint8_t address, const uint8_t *write_data, uint8_t write_len, uint32_t conversion,
+                   uint8_t read_len, i2c_transaction_callback_t &&callback);
+
   // ========== INTERNAL METHODS ==========
   // (In most use cases you won't need these)
   /// Begin a write transmission to an address.
@@ -119,6 +176,8 @@ class I2CComponent : public Component {
   /// Setup the i2c. bus
   void setup() override;
   void dump_config() override;
+  /// Run queued transactions.
+  void loop() override;
   /// Set a very high setup priority to make sure it's loaded before all other hardware.
   float get_setup_priority() const override;
 
@@ -128,6 +187,18 @@ class I2CComponent : public Component {
   uint8_t scl_pin_;
   uint32_t frequency_;
   bool scan_;
+  void finish_transaction_(size_t index, bool success);
+  I2CDeviceStats &get_stats_(uint8_t address);
+  void record_transfer_(uint8_t address, bool success, uint32_t started_at);
+  void log_stats_();
+
+  std::vector<I2CTransaction> transactions_;
+  uint32_t batch_window_{0};
+  uint32_t batch_started_{0};
+  /// Whether the current batch has been released and new transactions should start right away.
+  bool batch_running_{false};
+  uint32_t stats_interval_{0};
+  std::vector<I2CDeviceStats> device_stats_;
 };
 
 #ifdef ARDUINO_ARCH_ESP32
@@ -268,6 +339,25 @@ class I2CDevice {
   /// Write a single 16-bit word of data into the specified register. Return true if successful.
   bool write_byte_16(uint8_t a_register, uint16_t data);
 
+  /// Queue a transaction on the parent bus, see I2CComponent::transaction.
+  bool transaction(const uint8_t *write_data, uint8_t write_len, uint32_t conversion, uint8_t read_len,
+                   i2c_transaction_callback_t &&callback) {
+    return this->parent_->transaction(this->address_, write_data, write_len, conversion, read_len,
+                                      std::move(callback));
+  }
+
+  /** Read len amount of bytes from a register without blocking.
+   *
+   * @param a_register The register number to write to the bus before reading.
+   * @param len The amount of bytes to read.
+   * @param conversion The time in ms between writing the register value and reading out the value.
+   * @param callback Called with the result once the read has finished or failed.
+   * @return If the read could be queued.
+   */
+  bool read_bytes_async(uint8_t a_register, uint8_t len, uint32_t conversion, i2c_transaction_callback_t &&callback) {
+    return this->transaction(&a_register, 1, conversion, len, std::move(callback));
+  }
+
  protected:
   uint8_t address_{0x00};
   I2CComponent *parent_{nullptr};
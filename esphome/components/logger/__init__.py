@@ -73,11 +73,23 @@ LoggerMessageTrigger = logger_ns.class_('LoggerMessageTrigger',
                                         automation.Trigger.template(cg.int_, cg.const_char_ptr,
                                                                     cg.const_char_ptr))
 
+
+def validate_async_buffer_size(value):
+    async_buffer_size = value[CONF_ASYNC_BUFFER_SIZE]
+    if async_buffer_size != 0 and async_buffer_size < 2 * value[CONF_TX_BUFFER_SIZE] + 64:
+        raise cv.Invalid("async_buffer_size must be 0 (disabled) or at least twice tx_buffer_size "
+                         "plus 64 bytes ({} bytes).".format(2 * value[CONF_TX_BUFFER_SIZE] + 64),
+                         [CONF_ASYNC_BUFFER_SIZE])
+    return value
+
+
 CONF_ESP8266_STORE_LOG_STRINGS_IN_FLASH = 'esp8266_store_log_strings_in_flash'
+CONF_ASYNC_BUFFER_SIZE = 'async_buffer_size'
 CONFIG_SCHEMA = cv.All(cv.Schema({
     cv.GenerateID(): cv.declare_id(Logger),
     cv.Optional(CONF_BAUD_RATE, default=115200): cv.positive_int,
     cv.Optional(CONF_TX_BUFFER_SIZE, default=512): cv.validate_bytes,
+    cv.Optional(CONF_ASYNC_BUFFER_SIZE, default=0): cv.validate_bytes,
     cv.Optional(CONF_HARDWARE_UART, default='UART0'): uart_selection,
     cv.Optional(CONF_LEVEL, default='DEBUG'): is_log_level,
     cv.Optional(CONF_LOGS, default={}): cv.Schema({
@@ -90,7 +102,7 @@ CONFIG_SCHEMA = cv.All(cv.Schema({
 
     cv.SplitDefault(CONF_ESP8266_STORE_LOG_STRINGS_IN_FLASH, esp8266=True):
         cv.All(cv.only_on_esp8266, cv.boolean),
-}).extend(cv.COMPONENT_SCHEMA), validate_local_no_higher_than_global)
+}).extend(cv.COMPONENT_SCHEMA), validate_local_no_higher_than_global, validate_async_buffer_size)
 
 
 @coroutine_with_priority(90.0)
@@ -104,6 +116,8 @@ def to_code(config):
 
     for tag, level in config[CONF_LOGS].items():
         cg.add(log.set_log_level(tag, LOG_LEVELS[level]))
+    if config[CONF_ASYNC_BUFFER_SIZE] != 0:
+        cg.add(log.set_async_buffer_size(config[CONF_ASYNC_BUFFER_SIZE]))
 
     level = config[CONF_LEVEL]
     cg.add_define('USE_LOGGER')
@@ -4,6 +4,7 @@
 #include <esp_log.h>
 #endif
 #include <HardwareSerial.h>
+#include <algorithm>
 
 namespace esphome {
 namespace logger {
@@ -43,9 +44,23 @@ void Logger::write_header_(int level, const char *tag, int line) {
 }
 
 void HOT Logger::log_vprintf_(int level, const char *tag, int line, const char *format, va_list args) {  // NOLINT
-  if (level > this->level_for(tag))
+  if (level > this->min_tag_level_ && level > this->level_for(tag))
     return;
 
+  if (this->async_active_) {
+    if (!this->lock_async_())
+      return;
+    LogRecord *record = this->reserve_record_();
+    if (record == nullptr) {
+      this->dropped_messages_++;
+    } else {
+      int ret = vsnprintf(reinterpret_cast<char *>(record + 1), this->tx_buffer_size_ + 1, format, args);
+      this->commit_record_(record, level, tag, line, ret);
+    }
+    this->unlock_async_();
+    return;
+  }
+
   this->reset_buffer_();
   this->write_header_(level, tag, line);
   this->vprintf_to_buffer_(format, args);
@@ -55,9 +70,24 @@ void HOT Logger::log_vprintf_(int level, const char *tag, int line, const char *
 #ifdef USE_STORE_LOG_STR_IN_FLASH
 void Logger::log_vprintf_(int level, const char *tag, int line, const __FlashStringHelper *format,
                           va_list args) {  // NOLINT
-  if (level > this->level_for(tag))
+  if (level > this->min_tag_level_ && level > this->level_for(tag))
     return;
 
+  if (this->async_active_) {
+    // tx_buffer_ may be in use by loop(), so format straight from flash into the ring buffer
+    if (!this->lock_async_())
+      return;
+    LogRecord *record = this->reserve_record_();
+    if (record == nullptr) {
+      this->dropped_messages_++;
+    } else {
+      int ret = vsnprintf_P(reinterpret_cast<char *>(record + 1), this->tx_buffer_size_ + 1, (PGM_P) format, args);
+      this->commit_record_(record, level, tag, line, ret);
+    }
+    this->unlock_async_();
+    return;
+  }
+
   this->reset_buffer_();
   // copy format string
   const char *format_pgm_p = (PGM_P) format;
@@ -82,15 +112,27 @@ void Logger::log_vprintf_(int level, const char *tag, int line, const __FlashStr
 #endif
 
 int HOT Logger::level_for(const char *tag) {
-  // Uses std::vector<> for low memory footprint, though the vector
-  // could be sorted to minimize lookup times. This feature isn't used that
-  // much anyway so it doesn't matter too much.
-  for (auto &it : this->log_levels_) {
-    if (it.tag == tag) {
-      return it.level;
-    }
-  }
-  return ESPHOME_LOG_LEVEL;
+  if (this->log_levels_.empty())
+    return ESPHOME_LOG_LEVEL;
+
+  static_assert(ESPHOME_LOG_LEVEL_VERY_VERBOSE + 1 < TAG_LEVEL_CACHE_SIZE, "Log levels must fit into the index bits");
+
+  // Tags are static strings, so the address identifies a tag and the string only needs to be compared
+  // the first time a tag is seen.
+  const uintptr_t address = reinterpret_cast<uintptr_t>(tag);
+  auto &entry = this->tag_level_cache_[(address >> 2) % TAG_LEVEL_CACHE_SIZE];
+  const uintptr_t key = address & ~TAG_LEVEL_CACHE_INDEX_MASK;
+  const uintptr_t cached = entry.load(std::memory_order_relaxed);
+  if (cached != 0 && (cached & ~TAG_LEVEL_CACHE_INDEX_MASK) == key)
+    return int((cached & TAG_LEVEL_CACHE_INDEX_MASK) >> 2) - 1;
+
+  int level = ESPHOME_LOG_LEVEL;
+  auto it = std::lower_bound(this->log_levels_.begin(), this->log_levels_.end(), tag,
+                             [](const LogLevelOverride &a, const char *b) { return a.tag.compare(b) < 0; });
+  if (it != this->log_levels_.end() && it->tag == tag)
+    level = it->level;
+  entry.store(key | (uintptr_t(level + 1) << 2), std::memory_order_relaxed);
+  return level;
 }
 void HOT Logger::log_message_(int level, const char *tag, int offset) {
   // remove trailing newline
@@ -110,6 +152,102 @@ Logger::Logger(uint32_t baud_rate, size_t tx_buffer_size, UARTSelection uart)
     : baud_rate_(baud_rate), tx_buffer_size_(tx_buffer_size), uart_(uart) {
   // add 1 to buffer size for null terminator
   this->tx_buffer_ = new char[this->tx_buffer_size_ + 1];
+  // loop() only has work to do if messages were deferred
+  this->set_loop_on_wakeup_only(true);
+}
+
+bool HOT Logger::lock_async_() {
+#ifdef ARDUINO_ARCH_ESP32
+  // Formatting may allocate, so producers are serialized with a mutex instead of a critical section.
+  // A mutex can't be taken in an ISR, messages from there are dropped.
+  if (xPortInIsrContext())
+    return false;
+  xSemaphoreTake(this->async_lock_, portMAX_DELAY);
+#endif
+  return true;
+}
+void HOT Logger::unlock_async_() {
+#ifdef ARDUINO_ARCH_ESP32
+  xSemaphoreGive(this->async_lock_);
+#endif
+}
+Logger::LogRecord *HOT Logger::reserve_record_() {
+  const size_t max_size = record_size_(this->tx_buffer_size_);
+  const size_t tail = this->async_tail_.load();
+  size_t head = this->async_head_.load();
+
+  // head == tail means empty, so a record must never end exactly at the tail
+  if (head >= tail) {
+    if (this->async_buffer_size_ - head <= max_size) {
+      // not enough space at the end, continue at the start of the buffer
+      if (tail <= max_size)
+        return nullptr;
+      if (this->async_buffer_size_ - head >= sizeof(LogRecord))
+        reinterpret_cast<LogRecord *>(this->async_buffer_ + head)->length = WRAP_RECORD;
+      head = 0;
+    }
+  } else if (tail - head <= max_size) {
+    return nullptr;
+  }
+  return reinterpret_cast<LogRecord *>(this->async_buffer_ + head);
+}
+void HOT Logger::commit_record_(LogRecord *record, int level, const char *tag, int line, int length) {
+  if (length < 0)
+    // Encoding error, still log an empty message
+    length = 0;
+  if (length > this->tx_buffer_size_)
+    // output was too long, truncated
+    length = this->tx_buffer_size_;
+  record->tag = tag;
+  record->line = line;
+  record->length = length;
+  record->level = level;
+  // only publish the record once it's completely written
+  this->async_head_.store(reinterpret_cast<uint8_t *>(record) - this->async_buffer_ + record_size_(length));
+  this->wakeup();
+}
+void Logger::process_records_() {
+  // Messages logged while processing are handled in the next loop(), so this can't loop forever
+  const size_t head = this->async_head_.load();
+  size_t tail = this->async_tail_.load();
+  while (tail != head) {
+    auto *record = reinterpret_cast<LogRecord *>(this->async_buffer_ + tail);
+    if (this->async_buffer_size_ - tail < sizeof(LogRecord) || record->length == WRAP_RECORD) {
+      tail = 0;
+    } else {
+      this->reset_buffer_();
+      this->write_header_(record->level, record->tag, record->line);
+      this->write_to_buffer_(reinterpret_cast<const char *>(record + 1), record->length);
+      this->write_footer_();
+      this->log_message_(record->level, record->tag);
+      tail += record_size_(record->length);
+    }
+    this->async_tail_.store(tail);
+  }
+
+  const uint32_t dropped = this->dropped_messages_;
+  if (dropped != this->reported_dropped_messages_) {
+    this->reset_buffer_();
+    this->write_header_(ESPHOME_LOG_LEVEL_WARN, TAG, __LINE__);
+    this->printf_to_buffer_("Dropped %u log messages, consider increasing async_buffer_size",
+                            dropped - this->reported_dropped_messages_);
+    this->write_footer_();
+    this->log_message_(ESPHOME_LOG_LEVEL_WARN, TAG);
+    this->reported_dropped_messages_ = dropped;
+  }
+}
+void Logger::loop() {
+  if (this->async_buffer_ == nullptr)
+    return;
+  // Only start deferring now, so that everything logged before the main loop runs is written out directly
+  this->async_active_ = true;
+  this->process_records_();
+}
+void Logger::on_shutdown() {
+  if (this->async_buffer_ == nullptr)
+    return;
+  this->process_records_();
+  this->async_active_ = false;
 }
 
 void Logger::pre_setup() {
@@ -156,8 +294,29 @@ void Logger::pre_setup() {
   ESP_LOGI(TAG, "Log initialized");
 }
 void Logger::set_baud_rate(uint32_t baud_rate) { this->baud_rate_ = baud_rate; }
+void Logger::set_async_buffer_size(size_t async_buffer_size) {
+  if (async_buffer_size == 0)
+    return;
+  this->async_buffer_size_ = async_buffer_size;
+  // records are aligned, so is the buffer
+  this->async_buffer_ = reinterpret_cast<uint8_t *>(new LogRecord[async_buffer_size / sizeof(LogRecord) + 1]);
+#ifdef ARDUINO_ARCH_ESP32
+  this->async_lock_ = xSemaphoreCreateMutex();
+#endif
+}
 void Logger::set_log_level(const std::string &tag, int log_level) {
-  this->log_levels_.push_back(LogLevelOverride{tag, log_level});
+  auto it = std::lower_bound(this->log_levels_.begin(), this->log_levels_.end(), tag,
+                             [](const LogLevelOverride &a, const std::string &b) { return a.tag < b; });
+  if (it != this->log_levels_.end() && it->tag == tag) {
+    it->level = log_level;
+  } else {
+    this->log_levels_.insert(it, LogLevelOverride{tag, log_level});
+  }
+  this->min_tag_level_ = ESPHOME_LOG_LEVEL;
+  for (auto &level : this->log_levels_)
+    this->min_tag_level_ = std::min(this->min_tag_level_, level.level);
+  for (auto &entry : this->tag_level_cache_)
+    entry.store(0, std::memory_order_relaxed);
 }
 UARTSelection Logger::get_uart() const { return this->uart_; }
 void Logger::add_on_log_callback(std::function<void(int, const char *, const char *)> &&callback) {
@@ -176,6 +335,9 @@ void Logger::dump_config() {
   ESP_LOGCONFIG(TAG, "  Level: %s", LOG_LEVELS[ESPHOME_LOG_LEVEL]);
   ESP_LOGCONFIG(TAG, "  Log Baud Rate: %u", this->baud_rate_);
   ESP_LOGCONFIG(TAG, "  Hardware UART: %s", UART_SELECTIONS[this->uart_]);
+  if (this->async_buffer_ != nullptr) {
+    ESP_LOGCONFIG(TAG, "  Async Buffer Size: %u bytes", this->async_buffer_size_);
+  }
   for (auto &it : this->log_levels_) {
     ESP_LOGCONFIG(TAG, "  Level for '%s': %s", it.tag.c_str(), LOG_LEVELS[it.level]);
   }
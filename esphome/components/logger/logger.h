@@ -5,6 +5,12 @@
 #include "esphome/core/log.h"
 #include "esphome/core/helpers.h"
 #include "esphome/core/defines.h"
+#include <atomic>
+
+#ifdef ARDUINO_ARCH_ESP32
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#endif
 
 namespace esphome {
 
@@ -40,11 +46,23 @@ class Logger : public Component {
   /// Set the log level of the specified tag.
   void set_log_level(const std::string &tag, int log_level);
 
+  /** Defer writing log messages to serial and all log listeners to loop(), using a ring buffer of this size.
+   *
+   * Messages are still formatted right away (their arguments may not outlive the log call), but the
+   * slow part of writing them to the UART, API, MQTT and web server happens in the main loop.
+   * If the ring buffer overflows, messages are dropped and counted. Set to 0 to disable.
+   */
+  void set_async_buffer_size(size_t async_buffer_size);
+  /// Get the number of log messages dropped because the ring buffer was full.
+  uint32_t get_dropped_messages() const { return this->dropped_messages_; }
+
   // ========== INTERNAL METHODS ==========
   // (In most use cases you won't need these)
   /// Set up this component.
   void pre_setup();
   void dump_config() override;
+  void loop() override;
+  void on_shutdown() override;
 
   int level_for(const char *tag);
 
@@ -59,6 +77,30 @@ class Logger : public Component {
 #endif
 
  protected:
+  /// Header of a message in the ring buffer, followed by the null terminated message.
+  struct LogRecord {
+    const char *tag;
+    uint16_t line;
+    /// Length of the message, WRAP_RECORD if the rest of the ring buffer is unused and reading continues at 0.
+    uint16_t length;
+    uint8_t level;
+  };
+  static const uint16_t WRAP_RECORD = 0xFFFF;
+  static size_t record_size_(size_t length) {
+    // keep the next record aligned
+    return (sizeof(LogRecord) + length + 1 + alignof(LogRecord) - 1) & ~(alignof(LogRecord) - 1);
+  }
+
+  /// Serialize producers of the async ring buffer. Returns false if the message can't be deferred (from an ISR).
+  bool lock_async_();
+  void unlock_async_();
+  /// Reserve room for the longest possible message in the ring buffer, nullptr if it's full.
+  LogRecord *reserve_record_();
+  /// Publish a reserved record, length is the return value of vsnprintf for the message.
+  void commit_record_(LogRecord *record, int level, const char *tag, int line, int length);
+  /// Write all messages from the ring buffer to serial and the log listeners.
+  void process_records_();
+
   void write_header_(int level, const char *tag, int line);
   void write_footer_();
   void log_message_(int level, const char *tag, int offset = 0);
@@ -111,8 +153,34 @@ class Logger : public Component {
     std::string tag;
     int level;
   };
+  /// Sorted by tag.
   std::vector<LogLevelOverride> log_levels_;
+  /// Messages up to this level pass for every tag, so the per-tag level doesn't need to be looked up.
+  int min_tag_level_{ESPHOME_LOG_LEVEL};
+  /** Direct-mapped cache of per-tag levels, keyed by the address of the (static) tag string.
+   *
+   * Tasks log concurrently on the ESP32, so each entry is a single word: the tag address with the bits that select
+   * the entry replaced by level + 1. Zero marks an empty entry.
+   */
+  static const uint8_t TAG_LEVEL_CACHE_SIZE = 16;
+  static const uintptr_t TAG_LEVEL_CACHE_INDEX_MASK = uintptr_t(TAG_LEVEL_CACHE_SIZE - 1) << 2;
+  std::atomic<uintptr_t> tag_level_cache_[TAG_LEVEL_CACHE_SIZE]{};
   CallbackManager<void(int, const char *, const char *)> log_callback_{};
+
+  /** Ring buffer for deferred messages with a single consumer (loop()). Producers are serialized with
+   * lock_async_(), on the ESP32 messages are also logged from other FreeRTOS tasks.
+   */
+  uint8_t *async_buffer_{nullptr};
+  size_t async_buffer_size_{0};
+  std::atomic<size_t> async_head_{0};  ///< Write position, only changed by the producer holding the lock.
+  std::atomic<size_t> async_tail_{0};  ///< Read position, only changed by the consumer.
+  /// Messages are only deferred once the main loop runs loop() of the logger.
+  bool async_active_{false};
+#ifdef ARDUINO_ARCH_ESP32
+  SemaphoreHandle_t async_lock_{nullptr};
+#endif
+  uint32_t dropped_messages_{0};
+  uint32_t reported_dropped_messages_{0};
 };
 
 extern Logger *global_logger;
@@ -14,6 +14,11 @@ from esphome.const import CONF_AVAILABILITY, CONF_BIRTH_MESSAGE, CONF_BROKER, CO
     CONF_WILL_MESSAGE
 from esphome.core import coroutine_with_priority, coroutine, CORE
 
+CONF_OFFLINE_QUEUE = 'offline_queue'
+CONF_MAX_MESSAGES = 'max_messages'
+CONF_MAX_BYTES = 'max_bytes'
+CONF_DRAIN_INTERVAL = 'drain_interval'
+
 DEPENDENCIES = ['network']
 AUTO_LOAD = ['json', 'async_tcp']
 
@@ -122,6 +127,11 @@ CONFIG_SCHEMA = cv.All(cv.Schema({
                                                cv.ensure_list(validate_fingerprint)),
     cv.Optional(CONF_KEEPALIVE, default='15s'): cv.positive_time_period_seconds,
     cv.Optional(CONF_REBOOT_TIMEOUT, default='15min'): cv.positive_time_period_milliseconds,
+    cv.Optional(CONF_OFFLINE_QUEUE): cv.Schema({
+        cv.Optional(CONF_MAX_MESSAGES, default=32): cv.int_range(min=1, max=1024),
+        cv.Optional(CONF_MAX_BYTES, default=4096): cv.int_range(min=64),
+        cv.Optional(CONF_DRAIN_INTERVAL, default='50ms'): cv.positive_time_period_milliseconds,
+    }),
     cv.Optional(CONF_ON_MESSAGE): automation.validate_automation({
         cv.GenerateID(CONF_TRIGGER_ID): cv.declare_id(MQTTMessageTrigger),
         cv.Required(CONF_TOPIC): cv.subscribe_topic,
@@ -214,6 +224,11 @@ def to_code(config):
 
     cg.add(var.set_reboot_timeout(config[CONF_REBOOT_TIMEOUT]))
 
+    if CONF_OFFLINE_QUEUE in config:
+        conf = config[CONF_OFFLINE_QUEUE]
+        cg.add(var.set_offline_queue(conf[CONF_MAX_MESSAGES], conf[CONF_MAX_BYTES],
+                                     conf[CONF_DRAIN_INTERVAL]))
+
     for conf in config.get(CONF_ON_MESSAGE, []):
         trig = cg.new_Pvariable(conf[CONF_TRIGGER_ID], conf[CONF_TOPIC])
         cg.add(trig.set_qos(conf[CONF_QOS]))
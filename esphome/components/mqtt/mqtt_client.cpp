@@ -9,11 +9,15 @@
 #include "lwip/err.h"
 #include "lwip/dns.h"
 #include "mqtt_component.h"
+#include <algorithm>
+#include <cstring>
 
 namespace esphome {
 namespace mqtt {
 
 static const char *TAG = "mqtt";
+/// Largest incoming payload that is reassembled, anything larger is dropped instead of exhausting the heap.
+static const size_t MAX_INCOMING_PAYLOAD_SIZE = 4096;
 
 MQTTClientComponent::MQTTClientComponent() {
   global_mqtt_client = this;
@@ -25,9 +29,7 @@ void MQTTClientComponent::setup() {
   ESP_LOGCONFIG(TAG, "Setting up MQTT...");
   this->mqtt_client_.onMessage([this](char *topic, char *payload, AsyncMqttClientMessageProperties properties,
                                       size_t len, size_t index, size_t total) {
-    std::string payload_s(payload, len);
-    std::string topic_s(topic);
-    this->on_message(topic_s, payload_s);
+    this->on_message_fragment_(topic, payload, len, index, total);
   });
   this->mqtt_client_.onDisconnect([this](AsyncMqttClientDisconnectReason reason) {
     this->state_ = MQTT_CLIENT_DISCONNECTED;
@@ -64,6 +66,10 @@ void MQTTClientComponent::dump_config() {
   if (!this->availability_.topic.empty()) {
     ESP_LOGCONFIG(TAG, "  Availability: '%s'", this->availability_.topic.c_str());
   }
+  if (this->queue_.capacity() != 0) {
+    ESP_LOGCONFIG(TAG, "  Offline Queue: %u messages, %u bytes", this->queue_.capacity(), this->queue_max_bytes_);
+    ESP_LOGCONFIG(TAG, "  Offline Queue Drain Interval: %u ms", this->queue_drain_interval_);
+  }
 }
 bool MQTTClientComponent::can_proceed() { return this->is_connected(); }
 
@@ -207,6 +213,9 @@ void MQTTClientComponent::check_connected() {
 
   for (MQTTComponent *component : this->children_)
     component->schedule_resend_state();
+
+  // Start replaying queued messages one drain interval from now
+  this->last_queue_drain_ = millis();
 }
 
 void MQTTClientComponent::loop() {
@@ -269,8 +278,12 @@ void MQTTClientComponent::loop() {
         this->start_dnslookup_();
       } else {
         if (!this->birth_message_.topic.empty() && !this->sent_birth_message_) {
-          this->sent_birth_message_ = this->publish(this->birth_message_);
+          // Announce availability before replaying anything that was queued
+          this->sent_birth_message_ =
+              this->publish_(this->birth_message_.topic, this->birth_message_.payload.data(),
+                             this->birth_message_.payload.size(), this->birth_message_.qos, this->birth_message_.retain);
         }
+        this->drain_queue_();
 
         this->last_connected_ = now;
         this->resubscribe_subscriptions_();
@@ -278,6 +291,11 @@ void MQTTClientComponent::loop() {
       break;
   }
 
+  if (this->queue_dropped_ != 0) {
+    ESP_LOGW(TAG, "Offline queue full, dropped %u messages.", this->queue_dropped_);
+    this->queue_dropped_ = 0;
+  }
+
   if (millis() - this->last_connected_ > this->reboot_timeout_ && this->reboot_timeout_ != 0) {
     ESP_LOGE(TAG, "Can't connect to MQTT... Restarting...");
     App.reboot();
@@ -330,11 +348,13 @@ void MQTTClientComponent::subscribe(const std::string &topic, mqtt_callback_t ca
   };
   this->resubscribe_subscription_(&subscription);
   this->subscriptions_.push_back(subscription);
+  this->add_to_topic_trie_(topic, this->subscriptions_.size() - 1);
 }
 
 void MQTTClientComponent::subscribe_json(const std::string &topic, mqtt_json_callback_t callback, uint8_t qos) {
   auto f = [callback](const std::string &topic, const std::string &payload) {
-    json::parse_json(payload, [topic, callback](JsonObject &root) { callback(topic, root); });
+    // parse_json() calls back synchronously, capturing by reference keeps the std::function from allocating
+    json::parse_json(payload, [&topic, &callback](JsonObject &root) { callback(topic, root); });
   };
   MQTTSubscription subscription{
       .topic = topic,
@@ -345,6 +365,7 @@ void MQTTClientComponent::subscribe_json(const std::string &topic, mqtt_json_cal
   };
   this->resubscribe_subscription_(&subscription);
   this->subscriptions_.push_back(subscription);
+  this->add_to_topic_trie_(topic, this->subscriptions_.size() - 1);
 }
 
 // Publish
@@ -354,6 +375,32 @@ bool MQTTClientComponent::publish(const std::string &topic, const std::string &p
 
 bool MQTTClientComponent::publish(const std::string &topic, const char *payload, size_t payload_length, uint8_t qos,
                                   bool retain) {
+  return this->publish_(topic, payload, payload_length, qos, retain);
+}
+
+bool MQTTClientComponent::publish_queued(const std::string &topic, const std::string &payload, uint8_t qos,
+                                         bool retain) {
+  return this->publish_queued(topic, payload.data(), payload.size(), qos, retain);
+}
+
+bool MQTTClientComponent::publish_queued(const std::string &topic, const char *payload, size_t payload_length,
+                                         uint8_t qos, bool retain) {
+  const bool queue_enabled = this->queue_.capacity() != 0;
+  if (queue_enabled && (!this->is_connected() || !this->queue_.empty())) {
+    // Wait behind the messages that are already queued to keep the order
+    this->enqueue_(topic, payload, payload_length, qos, retain);
+    return true;
+  }
+  if (this->publish_(topic, payload, payload_length, qos, retain))
+    return true;
+  if (!queue_enabled)
+    return false;
+  this->enqueue_(topic, payload, payload_length, qos, retain);
+  return true;
+}
+
+bool MQTTClientComponent::publish_(const std::string &topic, const char *payload, size_t payload_length, uint8_t qos,
+                                   bool retain) {
   if (!this->is_connected()) {
     // critical components will re-transmit their messages
     return false;
@@ -379,6 +426,69 @@ bool MQTTClientComponent::publish(const std::string &topic, const char *payload,
   return ret != 0;
 }
 
+static size_t message_size(const MQTTMessage &message) { return message.topic.size() + message.payload.size(); }
+
+void MQTTClientComponent::enqueue_(const std::string &topic, const char *payload, size_t payload_length, uint8_t qos,
+                                   bool retain) {
+  bool coalesced = false;
+  if (retain) {
+    for (size_t i = 0; i < this->queue_.size(); i++) {
+      MQTTMessage &queued = this->queue_[i];
+      if (!queued.retain || queued.topic != topic)
+        continue;
+      this->queue_bytes_ -= queued.payload.size();
+      queued.payload.assign(payload, payload_length);
+      queued.qos = qos;
+      this->queue_bytes_ += payload_length;
+      coalesced = true;
+      break;
+    }
+  }
+
+  if (!coalesced) {
+    const size_t size = topic.size() + payload_length;
+    if (size > this->queue_max_bytes_) {
+      this->queue_dropped_++;
+      return;
+    }
+    while (this->queue_.full() || this->queue_bytes_ + size > this->queue_max_bytes_) {
+      this->queue_bytes_ -= message_size(this->queue_.front());
+      this->queue_.pop();
+      this->queue_dropped_++;
+    }
+    this->queue_.push(MQTTMessage{
+        .topic = topic,
+        .payload = std::string(payload, payload_length),
+        .qos = qos,
+        .retain = retain,
+    });
+    this->queue_bytes_ += size;
+  }
+
+  // A coalesced payload may have grown past the limit
+  while (this->queue_bytes_ > this->queue_max_bytes_) {
+    this->queue_bytes_ -= message_size(this->queue_.front());
+    this->queue_.pop();
+    this->queue_dropped_++;
+  }
+  ESP_LOGV(TAG, "Queued message for topic='%s' (%u queued)", topic.c_str(), this->queue_.size());
+}
+void MQTTClientComponent::drain_queue_() {
+  while (!this->queue_.empty()) {
+    const uint32_t now = millis();
+    if (this->queue_drain_interval_ != 0 && now - this->last_queue_drain_ < this->queue_drain_interval_)
+      return;
+
+    MQTTMessage &message = this->queue_.front();
+    if (!this->publish_(message.topic, message.payload.data(), message.payload.size(), message.qos, message.retain))
+      // Send buffer full, try again in the next loop
+      return;
+    this->queue_bytes_ -= message_size(message);
+    this->queue_.pop();
+    this->last_queue_drain_ = now;
+  }
+}
+
 bool MQTTClientComponent::publish(const MQTTMessage &message) {
   return this->publish(message.topic, message.payload, message.qos, message.retain);
 }
@@ -388,62 +498,107 @@ bool MQTTClientComponent::publish_json(const std::string &topic, const json::jso
   const char *message = json::build_json(f, &len);
   return this->publish(topic, message, len, qos, retain);
 }
-
-/** Check if the message topic matches the given subscription topic
- *
- * INFO: MQTT spec mandates that topics must not be empty and must be valid NULL-terminated UTF-8 strings.
- *
- * @param message The message topic that was received from the MQTT server. Note: this must not contain
- *                wildcard characters as mandated by the MQTT spec.
- * @param subscription The subscription topic we are matching against.
- * @param is_normal Is this a "normal" topic - Does the message topic not begin with a "$".
- * @param past_separator Are we past the first '/' topic separator.
- * @return true if the subscription topic matches the message topic, false otherwise.
- */
-static bool topic_match(const char *message, const char *subscription, bool is_normal, bool past_separator) {
-  // Reached end of both strings at the same time, this means we have a successful match
-  if (*message == '\0' && *subscription == '\0')
-    return true;
-
-  // Either the message or the subscribe are at the end. This means they don't match.
-  if (*message == '\0' || *subscription == '\0')
-    return false;
-
-  bool do_wildcards = is_normal || past_separator;
-
-  if (*subscription == '+' && do_wildcards) {
-    // single level wildcard
-    // consume + from subscription
-    subscription++;
-    // consume everything from message until '/' found or end of string
-    while (*message != '\0' && *message != '/') {
-      message++;
+bool MQTTClientComponent::publish_json_queued(const std::string &topic, const json::json_build_t &f, uint8_t qos,
+                                              bool retain) {
+  size_t len;
+  const char *message = json::build_json(f, &len);
+  return this->publish_queued(topic, message, len, qos, retain);
+}
+
+void MQTTClientComponent::add_to_topic_trie_(const std::string &topic, uint16_t index) {
+  if (this->topic_nodes_.empty())
+    this->topic_nodes_.emplace_back();
+
+  uint16_t node = 0;
+  size_t begin = 0;
+  while (true) {
+    size_t end = topic.find('/', begin);
+    if (end == std::string::npos)
+      end = topic.size();
+    if (end - begin == 1 && topic[begin] == '#') {
+      // multi-level wildcard - MQTT mandates that this must be at the end of the topic
+      this->topic_nodes_[node].multi_level_subscriptions.push_back(index);
+      return;
     }
-    // after this, both pointers will point to a '/' or to the end of the string
 
-    return topic_match(message, subscription, is_normal, true);
-  }
+    uint16_t child = 0;
+    for (uint16_t candidate : this->topic_nodes_[node].children) {
+      if (this->topic_nodes_[candidate].level.compare(0, std::string::npos, topic, begin, end - begin) == 0) {
+        child = candidate;
+        break;
+      }
+    }
+    if (child == 0) {
+      // The root is never a child, so 0 means not found
+      child = this->topic_nodes_.size();
+      this->topic_nodes_.emplace_back();
+      this->topic_nodes_[child].level = topic.substr(begin, end - begin);
+      this->topic_nodes_[node].children.push_back(child);
+    }
+    node = child;
 
-  if (*subscription == '#' && do_wildcards) {
-    // multilevel wildcard - MQTT mandates that this must be at end of subscribe topic
-    return true;
+    if (end == topic.size())
+      break;
+    begin = end + 1;
   }
+  this->topic_nodes_[node].subscriptions.push_back(index);
+}
 
-  // this handles '/' and normal characters at the same time.
-  if (*message != *subscription)
-    return false;
-
-  past_separator = past_separator || *subscription == '/';
+void MQTTClientComponent::match_topic_(uint16_t node, const char *rest, bool is_system) {
+  const MQTTTopicNode &current = this->topic_nodes_[node];
+  // MQTT mandates that wildcards in the first level don't match topics beginning with "$"
+  const bool wildcards = node != 0 || !is_system;
 
-  // consume characters
-  subscription++;
-  message++;
+  // "#" also matches the parent level itself, so "a/#" matches "a"
+  if (wildcards)
+    this->topic_matches_.insert(this->topic_matches_.end(), current.multi_level_subscriptions.begin(),
+                                current.multi_level_subscriptions.end());
+  if (rest == nullptr) {
+    this->topic_matches_.insert(this->topic_matches_.end(), current.subscriptions.begin(),
+                                current.subscriptions.end());
+    return;
+  }
 
-  return topic_match(message, subscription, is_normal, past_separator);
+  const char *separator = strchr(rest, '/');
+  const size_t length = separator != nullptr ? separator - rest : strlen(rest);
+  const char *next = separator != nullptr ? separator + 1 : nullptr;
+  for (uint16_t child : current.children) {
+    const std::string &level = this->topic_nodes_[child].level;
+    if (level.size() == length && level.compare(0, length, rest, length) == 0) {
+      this->match_topic_(child, next, is_system);
+    } else if (wildcards && level.size() == 1 && level[0] == '+') {
+      // single level wildcard
+      this->match_topic_(child, next, is_system);
+    }
+  }
 }
 
-static bool topic_match(const char *message, const char *subscription) {
-  return topic_match(message, subscription, *message != '\0' && *message != '$', false);
+void MQTTClientComponent::on_message_fragment_(const char *topic, const char *payload, size_t len, size_t index,
+                                               size_t total) {
+  if (total > MAX_INCOMING_PAYLOAD_SIZE) {
+    if (index == 0)
+      ESP_LOGW(TAG, "Dropping message for topic='%s', payload too large (%u > %u bytes)", topic, total,
+               MAX_INCOMING_PAYLOAD_SIZE);
+    this->incoming_payload_.clear();
+    return;
+  }
+  if (index == 0) {
+    this->incoming_topic_.assign(topic);
+    this->incoming_payload_.clear();
+    this->incoming_payload_.reserve(total);
+  } else if (index != this->incoming_payload_.size() || this->incoming_topic_ != topic) {
+    // Only happens if a fragment was lost, never deliver a partial payload
+    ESP_LOGW(TAG, "Dropping incomplete message for topic='%s' (fragment at %u of %u)", topic, index, total);
+    this->incoming_payload_.clear();
+    return;
+  }
+  this->incoming_payload_.append(payload, len);
+  if (this->incoming_payload_.size() < total)
+    return;
+
+  this->on_message(this->incoming_topic_, this->incoming_payload_);
+  // Keep the capacity for the next message, but make sure a stray fragment can't be appended to this one
+  this->incoming_payload_.clear();
 }
 
 void MQTTClientComponent::on_message(const std::string &topic, const std::string &payload) {
@@ -452,9 +607,14 @@ void MQTTClientComponent::on_message(const std::string &topic, const std::string
   // in an ISR.
   this->defer([this, topic, payload]() {
 #endif
-    for (auto &subscription : this->subscriptions_)
-      if (topic_match(topic.c_str(), subscription.topic.c_str()))
-        subscription.callback(topic, payload);
+    if (this->topic_nodes_.empty())
+      return;
+    this->topic_matches_.clear();
+    this->match_topic_(0, topic.c_str(), topic[0] == '$');
+    // Call the callbacks in the order they subscribed in
+    std::sort(this->topic_matches_.begin(), this->topic_matches_.end());
+    for (uint16_t index : this->topic_matches_)
+      this->subscriptions_[index].callback(topic, payload);
 #ifdef ARDUINO_ARCH_ESP8266
   });
 #endif
@@ -467,6 +627,12 @@ void MQTTClientComponent::set_reboot_timeout(uint32_t reboot_timeout) { this->re
 void MQTTClientComponent::register_mqtt_component(MQTTComponent *component) { this->children_.push_back(component); }
 void MQTTClientComponent::set_log_level(int level) { this->log_level_ = level; }
 void MQTTClientComponent::set_keep_alive(uint16_t keep_alive_s) { this->mqtt_client_.setKeepAlive(keep_alive_s); }
+void MQTTClientComponent::set_offline_queue(size_t max_messages, size_t max_bytes, uint32_t drain_interval) {
+  this->queue_.set_capacity(max_messages);
+  this->queue_bytes_ = 0;
+  this->queue_max_bytes_ = max_bytes;
+  this->queue_drain_interval_ = drain_interval;
+}
 void MQTTClientComponent::set_log_message_template(MQTTMessage &&message) { this->log_message_ = std::move(message); }
 const MQTTDiscoveryInfo &MQTTClientComponent::get_discovery_info() const { return this->discovery_info_; }
 void MQTTClientComponent::set_topic_prefix(std::string topic_prefix) { this->topic_prefix_ = std::move(topic_prefix); }
@@ -517,7 +683,8 @@ void MQTTClientComponent::disable_discovery() {
 void MQTTClientComponent::on_shutdown() {
   if (!this->shutdown_message_.topic.empty()) {
     yield();
-    this->publish(this->shutdown_message_);
+    this->publish_(this->shutdown_message_.topic, this->shutdown_message_.payload.data(),
+                   this->shutdown_message_.payload.size(), this->shutdown_message_.qos, this->shutdown_message_.retain);
     yield();
   }
   this->mqtt_client_.disconnect(true);
@@ -3,6 +3,7 @@
 #include "esphome/core/component.h"
 #include "esphome/core/defines.h"
 #include "esphome/core/automation.h"
+#include "esphome/core/helpers.h"
 #include "esphome/core/log.h"
 #include "esphome/components/json/json_util.h"
 #include <AsyncMqttClient.h>
@@ -35,6 +36,20 @@ struct MQTTSubscription {
   uint32_t resubscribe_timeout;
 };
 
+/** internal node of the subscription topic trie, one for each topic level.
+ *
+ * The "+" wildcard is stored as a child like any other level, a trailing "#" wildcard is stored with the node of the
+ * level before it. Indices refer to MQTTClientComponent::topic_nodes_ and MQTTClientComponent::subscriptions_.
+ */
+struct MQTTTopicNode {
+  std::string level;
+  std::vector<uint16_t> children;
+  /// Subscriptions whose topic ends at this level.
+  std::vector<uint16_t> subscriptions;
+  /// Subscriptions with a "#" wildcard after this level.
+  std::vector<uint16_t> multi_level_subscriptions;
+};
+
 /// internal struct for MQTT credentials.
 struct MQTTCredentials {
   std::string address;  ///< The address of the server without port number
@@ -90,6 +105,24 @@ class MQTTClientComponent : public Component {
   /// Set the keep alive time in seconds, every 0.7*keep_alive a ping will be sent.
   void set_keep_alive(uint16_t keep_alive_s);
 
+  /** Buffer publishes that can't be sent right away and replay them in order once connected.
+   *
+   * Messages sent with publish_queued() while disconnected (or that don't fit into the client's send buffer) are
+   * queued instead of being dropped. While the queue isn't empty, new messages are queued behind it so that order is
+   * kept. A retained message replaces a queued retained message for the same topic, since only the latest state
+   * matters for those.
+   *
+   * When the queue is full, the oldest messages are dropped first. Only messages that nothing would send again go
+   * through the queue (the mqtt.publish actions); component states and discovery messages use publish(), which
+   * fails while disconnected so that the components re-send them once connected.
+   *
+   * @param max_messages The maximum number of queued messages.
+   * @param max_bytes The maximum total size of queued topics and payloads.
+   * @param drain_interval The minimum time in ms between two replayed messages, so that a fleet of devices
+   *                       reconnecting at once doesn't flood the broker. 0 replays as fast as the client accepts them.
+   */
+  void set_offline_queue(size_t max_messages, size_t max_bytes, uint32_t drain_interval);
+
   /** Set the Home Assistant discovery info
    *
    * See <a href="https://www.home-assistant.io/docs/mqtt/discovery/">MQTT Discovery</a>.
@@ -184,6 +217,21 @@ class MQTTClientComponent : public Component {
    */
   bool publish_json(const std::string &topic, const json::json_build_t &f, uint8_t qos = 0, bool retain = false);
 
+  /** Publish a MQTT message, or add it to the offline queue if it can't be sent right away.
+   *
+   * Without an offline queue this is the same as publish(). See set_offline_queue().
+   *
+   * @return Whether the message was sent or queued.
+   */
+  bool publish_queued(const std::string &topic, const std::string &payload, uint8_t qos = 0, bool retain = false);
+
+  bool publish_queued(const std::string &topic, const char *payload, size_t payload_length, uint8_t qos = 0,
+                      bool retain = false);
+
+  /// Construct a JSON MQTT message and publish it with publish_queued().
+  bool publish_json_queued(const std::string &topic, const json::json_build_t &f, uint8_t qos = 0,
+                           bool retain = false);
+
   /// Setup the MQTT client, registering a bunch of callbacks and attempting to connect.
   void setup() override;
   void dump_config() override;
@@ -192,6 +240,11 @@ class MQTTClientComponent : public Component {
   /// MQTT client setup priority
   float get_setup_priority() const override;
 
+  /** Dispatch a received message to the matching subscriptions.
+   *
+   * On ESP32 topic and payload are the client's receive buffers, subscription callbacks get them without copies
+   * and must copy whatever they want to keep. On ESP8266 the message is copied once and dispatched from the main loop.
+   */
   void on_message(const std::string &topic, const std::string &payload);
 
   bool can_proceed() override;
@@ -226,6 +279,28 @@ class MQTTClientComponent : public Component {
   /// Re-calculate the availability property.
   void recalculate_availability_();
 
+  /// Send a message right away, bypassing the offline queue.
+  bool publish_(const std::string &topic, const char *payload, size_t payload_length, uint8_t qos, bool retain);
+  /// Add a message to the offline queue, coalescing retained messages by topic.
+  void enqueue_(const std::string &topic, const char *payload, size_t payload_length, uint8_t qos, bool retain);
+  /// Replay queued messages, limited by the drain interval.
+  void drain_queue_();
+
+  /** Reassemble a message that AsyncMqttClient delivers in fragments of len bytes at offset index.
+   *
+   * The fragments are collected in incoming_payload_, which is reused for every message so that receiving doesn't
+   * allocate once the buffer has grown to the usual message size. Messages larger than 4 KiB are dropped.
+   */
+  void on_message_fragment_(const char *topic, const char *payload, size_t len, size_t index, size_t total);
+  /// Add the subscription at index to the topic trie.
+  void add_to_topic_trie_(const std::string &topic, uint16_t index);
+  /** Collect the subscriptions matching a topic into topic_matches_.
+   *
+   * @param node The trie node of the levels matched so far.
+   * @param rest The remaining topic levels, nullptr once all levels are matched.
+   * @param is_system Whether the topic starts with "$", those aren't matched by wildcards in the first level.
+   */
+  void match_topic_(uint16_t node, const char *rest, bool is_system);
   bool subscribe_(const char *topic, uint8_t qos);
   void resubscribe_subscription_(MQTTSubscription *sub);
   void resubscribe_subscriptions_();
@@ -253,6 +328,12 @@ class MQTTClientComponent : public Component {
   int log_level_{ESPHOME_LOG_LEVEL};
 
   std::vector<MQTTSubscription> subscriptions_;
+  /// Subscription topics split into levels, the root is at index 0 once there's a subscription.
+  std::vector<MQTTTopicNode> topic_nodes_;
+  /// Subscriptions matching the message in on_message(), reused to avoid allocating for every message.
+  std::vector<uint16_t> topic_matches_;
+  std::string incoming_topic_;
+  std::string incoming_payload_;
   AsyncMqttClient mqtt_client_;
   MQTTClientState state_{MQTT_CLIENT_DISCONNECTED};
   IPAddress ip_;
@@ -263,6 +344,14 @@ class MQTTClientComponent : public Component {
   uint32_t connect_begin_;
   uint32_t last_connected_{0};
   optional<AsyncMqttClientDisconnectReason> disconnect_reason_{};
+  /// Messages waiting to be published, oldest first. Zero capacity disables the queue.
+  RingBuffer<MQTTMessage> queue_;
+  size_t queue_max_bytes_{0};
+  size_t queue_bytes_{0};
+  uint32_t queue_drain_interval_{0};
+  uint32_t last_queue_drain_{0};
+  /// Messages dropped from the full queue since this was last logged.
+  uint32_t queue_dropped_{0};
 };
 
 extern MQTTClientComponent *global_mqtt_client;
@@ -300,8 +389,8 @@ template<typename... Ts> class MQTTPublishAction : public Action<Ts...> {
   TEMPLATABLE_VALUE(bool, retain)
 
   void play(Ts... x) override {
-    this->parent_->publish(this->topic_.value(x...), this->payload_.value(x...), this->qos_.value(x...),
-                           this->retain_.value(x...));
+    this->parent_->publish_queued(this->topic_.value(x...), this->payload_.value(x...), this->qos_.value(x...),
+                                  this->retain_.value(x...));
   }
 
  protected:
@@ -321,7 +410,7 @@ template<typename... Ts> class MQTTPublishJsonAction : public Action<Ts...> {
     auto topic = this->topic_.value(x...);
     auto qos = this->qos_.value(x...);
     auto retain = this->retain_.value(x...);
-    this->parent_->publish_json(topic, f, qos, retain);
+    this->parent_->publish_json_queued(topic, f, qos, retain);
   }
 
  protected:
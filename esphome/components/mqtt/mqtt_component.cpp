@@ -22,16 +22,24 @@ std::string MQTTComponent::get_default_topic_for_(const std::string &suffix) con
          "/" + suffix;
 }
 
-const std::string MQTTComponent::get_state_topic_() const {
-  if (this->custom_state_topic_.empty())
-    return this->get_default_topic_for_("state");
-  return this->custom_state_topic_;
+const std::string &MQTTComponent::get_state_topic_() const {
+  if (this->state_topic_.empty()) {
+    if (this->custom_state_topic_.empty())
+      this->state_topic_ = this->get_default_topic_for_("state");
+    else
+      this->state_topic_ = this->custom_state_topic_;
+  }
+  return this->state_topic_;
 }
 
-const std::string MQTTComponent::get_command_topic_() const {
-  if (this->custom_command_topic_.empty())
-    return this->get_default_topic_for_("command");
-  return this->custom_command_topic_;
+const std::string &MQTTComponent::get_command_topic_() const {
+  if (this->command_topic_.empty()) {
+    if (this->custom_command_topic_.empty())
+      this->command_topic_ = this->get_default_topic_for_("command");
+    else
+      this->command_topic_ = this->custom_command_topic_;
+  }
+  return this->command_topic_;
 }
 
 bool MQTTComponent::publish(const std::string &topic, const std::string &payload) {
@@ -134,9 +142,11 @@ float MQTTComponent::get_setup_priority() const { return setup_priority::AFTER_C
 void MQTTComponent::disable_discovery() { this->discovery_enabled_ = false; }
 void MQTTComponent::set_custom_state_topic(const std::string &custom_state_topic) {
   this->custom_state_topic_ = custom_state_topic;
+  this->state_topic_.clear();
 }
 void MQTTComponent::set_custom_command_topic(const std::string &custom_command_topic) {
   this->custom_command_topic_ = custom_command_topic;
+  this->command_topic_.clear();
 }
 
 void MQTTComponent::set_availability(std::string topic, std::string payload_available,
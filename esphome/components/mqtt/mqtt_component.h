@@ -23,13 +23,21 @@ struct SendDiscoveryConfig {
 #define MQTT_COMPONENT_CUSTOM_TOPIC_(name, type) \
  protected: \
   std::string custom_##name##_##type##_topic_{}; \
+  mutable std::string name##_##type##_topic_{}; \
 \
  public: \
-  void set_custom_##name##_##type##_topic(const std::string &topic) { this->custom_##name##_##type##_topic_ = topic; } \
-  const std::string get_##name##_##type##_topic() const { \
-    if (this->custom_##name##_##type##_topic_.empty()) \
-      return this->get_default_topic_for_(#name "/" #type); \
-    return this->custom_##name##_##type##_topic_; \
+  void set_custom_##name##_##type##_topic(const std::string &topic) { \
+    this->custom_##name##_##type##_topic_ = topic; \
+    this->name##_##type##_topic_.clear(); \
+  } \
+  const std::string &get_##name##_##type##_topic() const { \
+    if (this->name##_##type##_topic_.empty()) { \
+      if (this->custom_##name##_##type##_topic_.empty()) \
+        this->name##_##type##_topic_ = this->get_default_topic_for_(#name "/" #type); \
+      else \
+        this->name##_##type##_topic_ = this->custom_##name##_##type##_topic_; \
+    } \
+    return this->name##_##type##_topic_; \
   }
 
 #define MQTT_COMPONENT_CUSTOM_TOPIC(name, type) MQTT_COMPONENT_CUSTOM_TOPIC_(name, type)
@@ -150,11 +158,11 @@ class MQTTComponent : public Component {
    */
   virtual std::string unique_id();
 
-  /// Get the MQTT topic that new states will be shared to.
-  const std::string get_state_topic_() const;
+  /// Get the MQTT topic that new states will be shared to. Built on first use, then cached.
+  const std::string &get_state_topic_() const;
 
-  /// Get the MQTT topic for listening to commands.
-  const std::string get_command_topic_() const;
+  /// Get the MQTT topic for listening to commands. Built on first use, then cached.
+  const std::string &get_command_topic_() const;
 
   bool is_connected_() const;
 
@@ -169,6 +177,9 @@ class MQTTComponent : public Component {
  protected:
   std::string custom_state_topic_{};
   std::string custom_command_topic_{};
+  /// Caches for get_state_topic_() and get_command_topic_(), so that publishing doesn't concatenate the topic.
+  mutable std::string state_topic_{};
+  mutable std::string command_topic_{};
   bool retain_{true};
   bool discovery_enabled_{true};
   Availability *availability_{nullptr};
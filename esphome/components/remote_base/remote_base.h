@@ -56,7 +56,8 @@ class RemoteTransmitData {
 
 class RemoteReceiveData {
  public:
-  RemoteReceiveData(std::vector<int32_t> *data, uint8_t tolerance) : data_(data), tolerance_(tolerance) {}
+  RemoteReceiveData(std::vector<int32_t> *data, uint8_t tolerance, uint32_t frame_id = 0)
+      : data_(data), tolerance_(tolerance), frame_id_(frame_id) {}
 
   bool peek_mark(uint32_t length, uint32_t offset = 0) {
     if (int32_t(this->index_ + offset) >= this->size())
@@ -126,6 +127,9 @@ class RemoteReceiveData {
 
   std::vector<int32_t> *get_raw_data() { return this->data_; }
 
+  /// Identifies the received frame within its receiver, 0 if the data doesn't come from a receiver.
+  uint32_t get_frame_id() const { return this->frame_id_; }
+
  protected:
   int32_t lower_bound_(uint32_t length) { return int32_t(100 - this->tolerance_) * length / 100U; }
   int32_t upper_bound_(uint32_t length) { return int32_t(100 + this->tolerance_) * length / 100U; }
@@ -133,6 +137,7 @@ class RemoteReceiveData {
   uint32_t index_{0};
   std::vector<int32_t> *data_;
   uint8_t tolerance_;
+  uint32_t frame_id_;
 };
 
 template<typename T> class RemoteProtocol {
@@ -144,6 +149,26 @@ template<typename T> class RemoteProtocol {
   virtual void dump(const T &data) = 0;
 };
 
+/** Decode a received frame with protocol T, at most once per frame.
+ *
+ * All binary sensors, triggers and dumpers of a protocol are handed the same frame one after another, so the first
+ * one decodes it and the others reuse the result. With many buttons of one protocol, a frame is thus decoded once
+ * per protocol instead of once per button.
+ */
+template<typename T, typename D> optional<D> decode_once(RemoteReceiveData src) {
+  static const std::vector<int32_t> *last_data = nullptr;
+  static uint32_t last_frame_id = 0;
+  static optional<D> last_result;
+  if (src.get_frame_id() == 0)
+    return T().decode(src);
+  if (src.get_raw_data() != last_data || src.get_frame_id() != last_frame_id) {
+    last_data = src.get_raw_data();
+    last_frame_id = src.get_frame_id();
+    last_result = T().decode(src);
+  }
+  return last_result;
+}
+
 class RemoteComponentBase {
  public:
   explicit RemoteComponentBase(GPIOPin *pin) : pin_(pin){};
@@ -236,7 +261,7 @@ class RemoteReceiverBase : public RemoteComponentBase {
   bool call_listeners_() {
     bool success = false;
     for (auto *listener : this->listeners_) {
-      auto data = RemoteReceiveData(&this->temp_, this->tolerance_);
+      auto data = RemoteReceiveData(&this->temp_, this->tolerance_, this->frame_id_);
       if (listener->on_receive(data))
         success = true;
     }
@@ -245,18 +270,21 @@ class RemoteReceiverBase : public RemoteComponentBase {
   void call_dumpers_() {
     bool success = false;
     for (auto *dumper : this->dumpers_) {
-      auto data = RemoteReceiveData(&this->temp_, this->tolerance_);
+      auto data = RemoteReceiveData(&this->temp_, this->tolerance_, this->frame_id_);
       if (dumper->dump(data))
         success = true;
     }
     if (!success) {
       for (auto *dumper : this->secondary_dumpers_) {
-        auto data = RemoteReceiveData(&this->temp_, this->tolerance_);
+        auto data = RemoteReceiveData(&this->temp_, this->tolerance_, this->frame_id_);
         dumper->dump(data);
       }
     }
   }
   void call_listeners_dumpers_() {
+    // New frame, invalidates the results cached by decode_once()
+    if (++this->frame_id_ == 0)
+      this->frame_id_ = 1;
     if (this->call_listeners_())
       return;
     // If a listener handled, then do not dump
@@ -268,6 +296,7 @@ class RemoteReceiverBase : public RemoteComponentBase {
   std::vector<RemoteReceiverDumperBase *> secondary_dumpers_;
   std::vector<int32_t> temp_;
   uint8_t tolerance_{25};
+  uint32_t frame_id_{0};
 };
 
 class RemoteReceiverBinarySensorBase : public binary_sensor::BinarySensorInitiallyOff,
@@ -294,8 +323,7 @@ template<typename T, typename D> class RemoteReceiverBinarySensor : public Remot
 
  protected:
   bool matches(RemoteReceiveData src) override {
-    auto proto = T();
-    auto res = proto.decode(src);
+    auto res = decode_once<T, D>(src);
     return res.has_value() && *res == this->data_;
   }
 
@@ -309,8 +337,7 @@ template<typename T, typename D> class RemoteReceiverBinarySensor : public Remot
 template<typename T, typename D> class RemoteReceiverTrigger : public Trigger<D>, public RemoteReceiverListener {
  protected:
   bool on_receive(RemoteReceiveData src) override {
-    auto proto = T();
-    auto res = proto.decode(src);
+    auto res = decode_once<T, D>(src);
     if (res.has_value()) {
       this->trigger(*res);
       return true;
@@ -343,11 +370,10 @@ template<typename... Ts> class RemoteTransmitterActionBase : public Action<Ts...
 template<typename T, typename D> class RemoteReceiverDumper : public RemoteReceiverDumperBase {
  public:
   bool dump(RemoteReceiveData src) override {
-    auto proto = T();
-    auto decoded = proto.decode(src);
+    auto decoded = decode_once<T, D>(src);
     if (!decoded.has_value())
       return false;
-    proto.dump(*decoded);
+    T().dump(*decoded);
     return true;
   }
 };
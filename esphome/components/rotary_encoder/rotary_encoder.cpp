@@ -91,16 +91,23 @@ void ICACHE_RAM_ATTR HOT RotaryEncoderSensorStore::gpio_intr(RotaryEncoderSensor
     input_state |= STATE_PIN_B_HIGH;
 
   uint16_t new_state = STATE_LOOKUP_TABLE[input_state];
+  bool changed = false;
   if ((new_state & arg->resolution & STATE_HAS_INCREMENTED) != 0) {
-    if (arg->counter < arg->max_value)
+    if (arg->counter < arg->max_value) {
       arg->counter++;
+      changed = true;
+    }
   }
   if ((new_state & arg->resolution & STATE_HAS_DECREMENTED) != 0) {
-    if (arg->counter > arg->min_value)
+    if (arg->counter > arg->min_value) {
       arg->counter--;
+      changed = true;
+    }
   }
 
   arg->state = new_state;
+  if (changed && arg->component != nullptr)
+    arg->component->wakeup();
 }
 
 void RotaryEncoderSensor::setup() {
@@ -112,6 +119,10 @@ void RotaryEncoderSensor::setup() {
 
   if (this->pin_i_ != nullptr) {
     this->pin_i_->setup();
+  } else {
+    // Without an index pin there's nothing to poll, only publish when the interrupt changed the counter
+    this->store_.component = this;
+    this->set_loop_on_wakeup_only(true);
   }
 
   this->pin_a_->attach_interrupt(RotaryEncoderSensorStore::gpio_intr, &this->store_, CHANGE);
@@ -26,6 +26,8 @@ struct RotaryEncoderSensorStore {
   int32_t max_value{INT32_MAX};
   int32_t last_read{0};
   uint8_t state{0};
+  /// Woken up on counter changes if it only loops on wakeups.
+  Component *component{nullptr};
 
   static void gpio_intr(RotaryEncoderSensorStore *arg);
 };
@@ -29,6 +29,10 @@ optional<RuuviParseResult> parse_ruuvi(const esp32_ble_tracker::ESPBTDevice &dev
 class RuuviListener : public esp32_ble_tracker::ESPBTDeviceListener {
  public:
   bool parse_device(const esp32_ble_tracker::ESPBTDevice &device) override;
+  esp32_ble_tracker::ESPBTListenerInterest get_interest() const override {
+    return esp32_ble_tracker::ESPBTListenerInterest::for_manufacturer_id(
+        esp32_ble_tracker::ESPBTUUID::from_uint16(0x0499));
+  }
 };
 
 }  // namespace ruuvi_ble
@@ -13,6 +13,9 @@ namespace ruuvitag {
 class RuuviTag : public Component, public esp32_ble_tracker::ESPBTDeviceListener {
  public:
   void set_address(uint64_t address) { address_ = address; }
+  esp32_ble_tracker::ESPBTListenerInterest get_interest() const override {
+    return esp32_ble_tracker::ESPBTListenerInterest::for_address(this->address_);
+  }
 
   bool parse_device(const esp32_ble_tracker::ESPBTDevice &device) override {
     if (device.address_uint64() != this->address_)
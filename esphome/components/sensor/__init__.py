@@ -8,7 +8,7 @@ from esphome.const import CONF_ABOVE, CONF_ACCURACY_DECIMALS, CONF_ALPHA, CONF_B
     CONF_EXPIRE_AFTER, CONF_FILTERS, CONF_FROM, CONF_ICON, CONF_ID, CONF_INTERNAL, \
     CONF_ON_RAW_VALUE, CONF_ON_VALUE, CONF_ON_VALUE_RANGE, CONF_SEND_EVERY, CONF_SEND_FIRST_AT, \
     CONF_TO, CONF_TRIGGER_ID, CONF_UNIT_OF_MEASUREMENT, CONF_WINDOW_SIZE, CONF_NAME, CONF_MQTT_ID, \
-    CONF_FORCE_UPDATE
+    CONF_FORCE_UPDATE, CONF_QUANTILE
 from esphome.core import CORE, coroutine, coroutine_with_priority
 from esphome.util import Registry
 
@@ -60,7 +60,11 @@ SensorPublishAction = sensor_ns.class_('SensorPublishAction', automation.Action)
 
 # Filters
 Filter = sensor_ns.class_('Filter')
-MedianFilter = sensor_ns.class_('MedianFilter', Filter)
+SortedWindowFilter = sensor_ns.class_('SortedWindowFilter', Filter)
+MedianFilter = sensor_ns.class_('MedianFilter', SortedWindowFilter)
+QuantileFilter = sensor_ns.class_('QuantileFilter', SortedWindowFilter)
+MinFilter = sensor_ns.class_('MinFilter', SortedWindowFilter)
+MaxFilter = sensor_ns.class_('MaxFilter', SortedWindowFilter)
 SlidingWindowMovingAverageFilter = sensor_ns.class_('SlidingWindowMovingAverageFilter', Filter)
 ExponentialMovingAverageFilter = sensor_ns.class_('ExponentialMovingAverageFilter', Filter)
 LambdaFilter = sensor_ns.class_('LambdaFilter', Filter)
@@ -141,6 +145,32 @@ def median_filter_to_code(config, filter_id):
                            config[CONF_SEND_FIRST_AT])
 
 
+QUANTILE_SCHEMA = cv.All(cv.Schema({
+    cv.Optional(CONF_WINDOW_SIZE, default=5): cv.positive_not_null_int,
+    cv.Optional(CONF_SEND_EVERY, default=5): cv.positive_not_null_int,
+    cv.Optional(CONF_SEND_FIRST_AT, default=1): cv.positive_not_null_int,
+    cv.Optional(CONF_QUANTILE, default=0.9): cv.zero_to_one_float,
+}), validate_send_first_at)
+
+
+@FILTER_REGISTRY.register('quantile', QuantileFilter, QUANTILE_SCHEMA)
+def quantile_filter_to_code(config, filter_id):
+    yield cg.new_Pvariable(filter_id, config[CONF_WINDOW_SIZE], config[CONF_SEND_EVERY],
+                           config[CONF_SEND_FIRST_AT], config[CONF_QUANTILE])
+
+
+@FILTER_REGISTRY.register('min', MinFilter, MEDIAN_SCHEMA)
+def min_filter_to_code(config, filter_id):
+    yield cg.new_Pvariable(filter_id, config[CONF_WINDOW_SIZE], config[CONF_SEND_EVERY],
+                           config[CONF_SEND_FIRST_AT])
+
+
+@FILTER_REGISTRY.register('max', MaxFilter, MEDIAN_SCHEMA)
+def max_filter_to_code(config, filter_id):
+    yield cg.new_Pvariable(filter_id, config[CONF_WINDOW_SIZE], config[CONF_SEND_EVERY],
+                           config[CONF_SEND_FIRST_AT])
+
+
 SLIDING_AVERAGE_SCHEMA = cv.All(cv.Schema({
     cv.Optional(CONF_WINDOW_SIZE, default=15): cv.positive_not_null_int,
     cv.Optional(CONF_SEND_EVERY, default=15): cv.positive_not_null_int,
@@ -39,64 +39,119 @@ uint32_t Filter::calculate_remaining_interval(uint32_t input) {
   }
 }
 
-// MedianFilter
-MedianFilter::MedianFilter(size_t window_size, size_t send_every, size_t send_first_at)
-    : send_every_(send_every), send_at_(send_every - send_first_at), window_size_(window_size) {}
-void MedianFilter::set_send_every(size_t send_every) { this->send_every_ = send_every; }
-void MedianFilter::set_window_size(size_t window_size) { this->window_size_ = window_size; }
-optional<float> MedianFilter::new_value(float value) {
+// SortedWindowFilter
+SortedWindowFilter::SortedWindowFilter(size_t window_size, size_t send_every, size_t send_first_at)
+    : send_every_(send_every), send_at_(send_every - send_first_at) {
+  this->set_window_size(window_size);
+}
+void SortedWindowFilter::set_send_every(size_t send_every) { this->send_every_ = send_every; }
+void SortedWindowFilter::set_window_size(size_t window_size) {
+  this->window_.set_capacity(window_size);
+  this->sorted_.clear();
+  this->sorted_.reserve(window_size);
+}
+optional<float> SortedWindowFilter::new_value(float value) {
   if (!isnan(value)) {
-    while (this->queue_.size() >= this->window_size_) {
-      this->queue_.pop_front();
+    if (!this->window_.full()) {
+      this->window_.push(value);
+      this->sorted_.insert(std::upper_bound(this->sorted_.begin(), this->sorted_.end(), value), value);
+    } else {
+      const float oldest = this->window_.front();
+      this->window_.push(value);
+
+      // Replace the oldest value in the sorted window, shifting only the values in between
+      auto removed = std::lower_bound(this->sorted_.begin(), this->sorted_.end(), oldest);
+      auto inserted = std::upper_bound(this->sorted_.begin(), this->sorted_.end(), value);
+      if (inserted > removed) {
+        std::move(removed + 1, inserted, removed);
+        *(inserted - 1) = value;
+      } else {
+        std::move_backward(inserted, removed, removed + 1);
+        *inserted = value;
+      }
     }
-    this->queue_.push_back(value);
-    ESP_LOGVV(TAG, "MedianFilter(%p)::new_value(%f)", this, value);
+    ESP_LOGVV(TAG, "SortedWindowFilter(%p)::new_value(%f)", this, value);
   }
 
   if (++this->send_at_ >= this->send_every_) {
     this->send_at_ = 0;
 
-    float median = 0.0f;
-    if (!this->queue_.empty()) {
-      std::deque<float> median_queue = this->queue_;
-      sort(median_queue.begin(), median_queue.end());
+    float result = 0.0f;
+    if (!this->sorted_.empty())
+      result = this->compute_result_();
 
-      size_t queue_size = median_queue.size();
-      if (queue_size % 2) {
-        median = median_queue[queue_size / 2];
-      } else {
-        median = (median_queue[queue_size / 2] + median_queue[(queue_size / 2) - 1]) / 2.0f;
-      }
-    }
-
-    ESP_LOGVV(TAG, "MedianFilter(%p)::new_value(%f) SENDING", this, median);
-    return median;
+    ESP_LOGVV(TAG, "SortedWindowFilter(%p)::new_value(%f) SENDING %f", this, value, result);
+    return result;
   }
   return {};
 }
+float SortedWindowFilter::calculate_quantile_(float quantile) const {
+  const float position = quantile * (this->sorted_.size() - 1);
+  const size_t lower = position;
+  if (lower + 1 >= this->sorted_.size())
+    return this->sorted_.back();
+  return this->sorted_[lower] + (this->sorted_[lower + 1] - this->sorted_[lower]) * (position - lower);
+}
+uint32_t SortedWindowFilter::expected_interval(uint32_t input) { return input * this->send_every_; }
 
-uint32_t MedianFilter::expected_interval(uint32_t input) { return input * this->send_every_; }
+// MedianFilter
+MedianFilter::MedianFilter(size_t window_size, size_t send_every, size_t send_first_at)
+    : SortedWindowFilter(window_size, send_every, send_first_at) {}
+float MedianFilter::compute_result_() {
+  size_t size = this->sorted_.size();
+  if (size % 2)
+    return this->sorted_[size / 2];
+  return (this->sorted_[size / 2] + this->sorted_[(size / 2) - 1]) / 2.0f;
+}
+
+// QuantileFilter
+QuantileFilter::QuantileFilter(size_t window_size, size_t send_every, size_t send_first_at, float quantile)
+    : SortedWindowFilter(window_size, send_every, send_first_at), quantile_(quantile) {}
+void QuantileFilter::set_quantile(float quantile) { this->quantile_ = quantile; }
+float QuantileFilter::compute_result_() { return this->calculate_quantile_(this->quantile_); }
+
+// MinFilter
+MinFilter::MinFilter(size_t window_size, size_t send_every, size_t send_first_at)
+    : SortedWindowFilter(window_size, send_every, send_first_at) {}
+float MinFilter::compute_result_() { return this->sorted_.front(); }
+
+// MaxFilter
+MaxFilter::MaxFilter(size_t window_size, size_t send_every, size_t send_first_at)
+    : SortedWindowFilter(window_size, send_every, send_first_at) {}
+float MaxFilter::compute_result_() { return this->sorted_.back(); }
 
 // SlidingWindowMovingAverageFilter
 SlidingWindowMovingAverageFilter::SlidingWindowMovingAverageFilter(size_t window_size, size_t send_every,
                                                                    size_t send_first_at)
-    : send_every_(send_every), send_at_(send_every - send_first_at), window_size_(window_size) {}
+    : window_(window_size), send_every_(send_every), send_at_(send_every - send_first_at) {}
 void SlidingWindowMovingAverageFilter::set_send_every(size_t send_every) { this->send_every_ = send_every; }
-void SlidingWindowMovingAverageFilter::set_window_size(size_t window_size) { this->window_size_ = window_size; }
+void SlidingWindowMovingAverageFilter::set_window_size(size_t window_size) {
+  this->window_.set_capacity(window_size);
+  this->sum_ = 0.0f;
+  this->sum_compensation_ = 0.0f;
+}
+void SlidingWindowMovingAverageFilter::add_to_sum_(float value) {
+  // Kahan-Babuska summation: collect the rounding error of each addition separately
+  const float sum = this->sum_ + value;
+  if (fabsf(this->sum_) >= fabsf(value)) {
+    this->sum_compensation_ += (this->sum_ - sum) + value;
+  } else {
+    this->sum_compensation_ += (value - sum) + this->sum_;
+  }
+  this->sum_ = sum;
+}
 optional<float> SlidingWindowMovingAverageFilter::new_value(float value) {
   if (!isnan(value)) {
-    if (this->queue_.size() == this->window_size_) {
-      this->sum_ -= this->queue_.front();
-      this->queue_.pop();
-    }
-    this->queue_.push(value);
-    this->sum_ += value;
+    if (this->window_.full())
+      this->add_to_sum_(-this->window_.front());
+    this->window_.push(value);
+    this->add_to_sum_(value);
   }
   float average;
-  if (this->queue_.empty())
+  if (this->window_.empty())
     average = 0.0f;
   else
-    average = this->sum_ / this->queue_.size();
+    average = (this->sum_ + this->sum_compensation_) / this->window_.size();
   ESP_LOGVV(TAG, "SlidingWindowMovingAverageFilter(%p)::new_value(%f) -> %f", this, value, average);
 
   if (++this->send_at_ >= this->send_every_) {
@@ -1,6 +1,6 @@
 #pragma once
 
-#include <queue>
+#include <vector>
 #include "esphome/core/component.h"
 #include "esphome/core/helpers.h"
 
@@ -46,21 +46,22 @@ class Filter {
   Sensor *parent_{nullptr};
 };
 
-/** Simple median filter.
+/** Base class for filters that push out an order statistic of the last <window_size> values.
  *
- * Takes the median of the last <send_every> values and pushes it out every <send_every>.
+ * Next to the window in insertion order, a sorted copy of it is kept up to date with a binary search and a single
+ * shift per value, so no allocation or sort is needed when sending. Both are allocated once for the window size.
  */
-class MedianFilter : public Filter {
+class SortedWindowFilter : public Filter {
  public:
-  /** Construct a MedianFilter.
+  /** Construct a SortedWindowFilter.
    *
-   * @param window_size The number of values that should be used in median calculation.
+   * @param window_size The number of values the order statistic is taken over.
    * @param send_every After how many sensor values should a new one be pushed out.
    * @param send_first_at After how many values to forward the very first value. Defaults to the first value
    *   on startup being published on the first *raw* value, so with no filter applied. Must be less than or equal to
    *   send_every.
    */
-  explicit MedianFilter(size_t window_size, size_t send_every, size_t send_first_at);
+  SortedWindowFilter(size_t window_size, size_t send_every, size_t send_first_at);
 
   optional<float> new_value(float value) override;
 
@@ -70,16 +71,73 @@ class MedianFilter : public Filter {
   uint32_t expected_interval(uint32_t input) override;
 
  protected:
-  std::deque<float> queue_;
+  /// Calculate the value to push out from sorted_, which holds at least one value.
+  virtual float compute_result_() = 0;
+
+  /// The given quantile (0-1) of the window, linearly interpolated between the closest ranks.
+  float calculate_quantile_(float quantile) const;
+
+  RingBuffer<float> window_;
+  std::vector<float> sorted_;
   size_t send_every_;
   size_t send_at_;
-  size_t window_size_;
+};
+
+/** Simple median filter.
+ *
+ * Takes the median of the last <window_size> values and pushes it out every <send_every>.
+ */
+class MedianFilter : public SortedWindowFilter {
+ public:
+  /** Construct a MedianFilter.
+   *
+   * @param window_size The number of values that should be used in median calculation.
+   * @param send_every After how many sensor values should a new one be pushed out.
+   * @param send_first_at After how many values to forward the very first value. Defaults to the first value
+   *   on startup being published on the first *raw* value, so with no filter applied. Must be less than or equal to
+   *   send_every.
+   */
+  explicit MedianFilter(size_t window_size, size_t send_every, size_t send_first_at);
+
+ protected:
+  float compute_result_() override;
+};
+
+/// Takes the <quantile> (0-1) of the last <window_size> values and pushes it out every <send_every>.
+class QuantileFilter : public SortedWindowFilter {
+ public:
+  QuantileFilter(size_t window_size, size_t send_every, size_t send_first_at, float quantile);
+
+  void set_quantile(float quantile);
+
+ protected:
+  float compute_result_() override;
+
+  float quantile_;
+};
+
+/// Takes the minimum of the last <window_size> values and pushes it out every <send_every>.
+class MinFilter : public SortedWindowFilter {
+ public:
+  MinFilter(size_t window_size, size_t send_every, size_t send_first_at);
+
+ protected:
+  float compute_result_() override;
+};
+
+/// Takes the maximum of the last <window_size> values and pushes it out every <send_every>.
+class MaxFilter : public SortedWindowFilter {
+ public:
+  MaxFilter(size_t window_size, size_t send_every, size_t send_first_at);
+
+ protected:
+  float compute_result_() override;
 };
 
 /** Simple sliding window moving average filter.
  *
  * Essentially just takes takes the average of the last window_size values and pushes them out
- * every send_every.
+ * every send_every. The running sum is Kahan-compensated so it doesn't drift over long runs.
  */
 class SlidingWindowMovingAverageFilter : public Filter {
  public:
@@ -101,11 +159,13 @@ class SlidingWindowMovingAverageFilter : public Filter {
   uint32_t expected_interval(uint32_t input) override;
 
  protected:
-  float sum_{0.0};
-  std::queue<float> queue_;
+  void add_to_sum_(float value);
+
+  float sum_{0.0f};
+  float sum_compensation_{0.0f};
+  RingBuffer<float> window_;
   size_t send_every_;
   size_t send_at_;
-  size_t window_size_;
 };
 
 /** Simple exponential moving average filter.
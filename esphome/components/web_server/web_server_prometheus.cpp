@@ -55,6 +55,12 @@ void WebServerPrometheus::handle_request(AsyncWebServerRequest *request) {
     this->switch_row_(stream, obj);
 #endif
 
+#ifdef USE_PROFILER
+  this->component_profile_type_(stream);
+  for (auto *obj : App.get_components())
+    this->component_profile_row_(stream, obj);
+#endif
+
   request->send(stream);
 }
 
@@ -340,5 +346,65 @@ void WebServerPrometheus::switch_row_(AsyncResponseStream *stream, switch_::Swit
 }
 #endif
 
+#ifdef USE_PROFILER
+void WebServerPrometheus::component_profile_type_(AsyncResponseStream *stream) {
+  stream->print(F("#TYPE esphome_component_loop_seconds HISTOGRAM\n"));
+  stream->print(F("#TYPE esphome_component_loop_min_seconds GAUGE\n"));
+  stream->print(F("#TYPE esphome_component_loop_max_seconds GAUGE\n"));
+  stream->print(F("#TYPE esphome_component_scheduler_seconds HISTOGRAM\n"));
+  stream->print(F("#TYPE esphome_component_scheduler_min_seconds GAUGE\n"));
+  stream->print(F("#TYPE esphome_component_scheduler_max_seconds GAUGE\n"));
+}
+void WebServerPrometheus::component_profile_row_(AsyncResponseStream *stream, Component *obj) {
+  this->profile_stats_rows_(stream, "esphome_component_loop", obj->get_component_source(), obj->get_loop_stats());
+  this->profile_stats_rows_(stream, "esphome_component_scheduler", obj->get_component_source(),
+                            obj->get_scheduler_stats());
+}
+void WebServerPrometheus::profile_stats_rows_(AsyncResponseStream *stream, const char *metric, const char *id,
+                                              const ProfileStats &stats) {
+  // Buckets are cumulative in prometheus
+  uint32_t cumulative = 0;
+  for (uint8_t i = 0; i < PROFILE_STATS_BUCKETS; i++) {
+    cumulative += stats.get_bucket(i);
+    stream->print(metric);
+    stream->print(F("_seconds_bucket{id=\""));
+    stream->print(id);
+    stream->print(F("\",le=\""));
+    if (i < PROFILE_STATS_BUCKETS - 1) {
+      stream->print(PROFILE_STATS_BUCKET_LIMITS[i] / 1e6f, 4);
+    } else {
+      stream->print(F("+Inf"));
+    }
+    stream->print(F("\"} "));
+    stream->print(cumulative);
+    stream->print('\n');
+  }
+  stream->print(metric);
+  stream->print(F("_seconds_sum{id=\""));
+  stream->print(id);
+  stream->print(F("\"} "));
+  stream->print(stats.get_total_us() / 1e6, 6);
+  stream->print('\n');
+  stream->print(metric);
+  stream->print(F("_seconds_count{id=\""));
+  stream->print(id);
+  stream->print(F("\"} "));
+  stream->print(stats.get_count());
+  stream->print('\n');
+  stream->print(metric);
+  stream->print(F("_min_seconds{id=\""));
+  stream->print(id);
+  stream->print(F("\"} "));
+  stream->print(stats.get_min_us() / 1e6f, 6);
+  stream->print('\n');
+  stream->print(metric);
+  stream->print(F("_max_seconds{id=\""));
+  stream->print(id);
+  stream->print(F("\"} "));
+  stream->print(stats.get_max_us() / 1e6f, 6);
+  stream->print('\n');
+}
+#endif
+
 }  // namespace web_server
 }  // namespace esphome
@@ -55,6 +55,15 @@ class WebServerPrometheus {
   /// Return the switch Values state as prometheus data point
   void switch_row_(AsyncResponseStream *stream, switch_::Switch *obj);
 #endif
+
+#ifdef USE_PROFILER
+  /// Return the type for prometheus
+  void component_profile_type_(AsyncResponseStream *stream);
+  /// Return the loop/scheduler timing of a component as prometheus histograms
+  void component_profile_row_(AsyncResponseStream *stream, Component *obj);
+  /// Return a single timing histogram (with min/max gauges) of the given metric
+  void profile_stats_rows_(AsyncResponseStream *stream, const char *metric, const char *id, const ProfileStats &stats);
+#endif
 };
 
 }  // namespace web_server
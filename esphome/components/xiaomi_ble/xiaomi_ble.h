@@ -65,6 +65,10 @@ bool report_xiaomi_results(const optional<XiaomiParseResult> &result, const std:
 class XiaomiListener : public esp32_ble_tracker::ESPBTDeviceListener {
  public:
   bool parse_device(const esp32_ble_tracker::ESPBTDevice &device) override;
+  esp32_ble_tracker::ESPBTListenerInterest get_interest() const override {
+    return esp32_ble_tracker::ESPBTListenerInterest::for_service_uuid(
+        esp32_ble_tracker::ESPBTUUID::from_uint16(0xFE95));
+  }
 };
 
 }  // namespace xiaomi_ble
@@ -13,6 +13,9 @@ namespace xiaomi_cgd1 {
 class XiaomiCGD1 : public Component, public esp32_ble_tracker::ESPBTDeviceListener {
  public:
   void set_address(uint64_t address) { address_ = address; };
+  esp32_ble_tracker::ESPBTListenerInterest get_interest() const override {
+    return esp32_ble_tracker::ESPBTListenerInterest::for_address(this->address_);
+  }
   void set_bindkey(const std::string &bindkey);
 
   bool parse_device(const esp32_ble_tracker::ESPBTDevice &device) override;
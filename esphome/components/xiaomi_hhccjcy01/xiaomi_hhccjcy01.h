@@ -13,6 +13,9 @@ namespace xiaomi_hhccjcy01 {
 class XiaomiHHCCJCY01 : public Component, public esp32_ble_tracker::ESPBTDeviceListener {
  public:
   void set_address(uint64_t address) { address_ = address; }
+  esp32_ble_tracker::ESPBTListenerInterest get_interest() const override {
+    return esp32_ble_tracker::ESPBTListenerInterest::for_address(this->address_);
+  }
 
   bool parse_device(const esp32_ble_tracker::ESPBTDevice &device) override;
 
@@ -63,9 +63,15 @@ class ComponentManifest:
     def conflicts_with(self):
         return getattr(self.module, 'CONFLICTS_WITH', [])
 
-    @property
-    def auto_load(self):
-        return getattr(self.module, 'AUTO_LOAD', [])
+    def get_auto_load(self, config):
+        """Get the components to load with this one.
+
+        AUTO_LOAD can also be a function of the (not yet validated) config of this component.
+        """
+        auto_load = getattr(self.module, 'AUTO_LOAD', [])
+        if callable(auto_load):
+            return auto_load(config)
+        return auto_load
 
     def _get_flags_set(self, name, config):
         if not hasattr(self.module, name):
@@ -458,7 +464,7 @@ def validate_config(config):
         CORE.loaded_integrations.add(domain)
 
         # Process AUTO_LOAD
-        for load in component.auto_load:
+        for load in component.get_auto_load(conf):
             if load not in config:
                 load_conf = core.AutoLoad()
                 config[load] = load_conf
@@ -503,7 +509,7 @@ def validate_config(config):
             CORE.loaded_integrations.add(p_name)
 
             # Process AUTO_LOAD
-            for load in platform.auto_load:
+            for load in platform.get_auto_load(p_config):
                 if load not in config:
                     load_conf = core.AutoLoad()
                     config[load] = load_conf
@@ -118,6 +118,7 @@ CONF_DAYS_OF_MONTH = 'days_of_month'
 CONF_DAYS_OF_WEEK = 'days_of_week'
 CONF_DC_PIN = 'dc_pin'
 CONF_DEBOUNCE = 'debounce'
+CONF_DEBUG = 'debug'
 CONF_DECELERATION = 'deceleration'
 CONF_DEFAULT_TARGET_TEMPERATURE_HIGH = 'default_target_temperature_high'
 CONF_DEFAULT_TARGET_TEMPERATURE_LOW = 'default_target_temperature_low'
@@ -164,6 +165,7 @@ CONF_FILTER = 'filter'
 CONF_FILTER_OUT = 'filter_out'
 CONF_FILTERS = 'filters'
 CONF_FLASH_LENGTH = 'flash_length'
+CONF_FLASH_WRITE_INTERVAL = 'flash_write_interval'
 CONF_FOR = 'for'
 CONF_FORCE_UPDATE = 'force_update'
 CONF_FORMALDEHYDE = 'formaldehyde'
@@ -359,11 +361,13 @@ CONF_POWER_SAVE_MODE = 'power_save_mode'
 CONF_POWER_SUPPLY = 'power_supply'
 CONF_PRESSURE = 'pressure'
 CONF_PRIORITY = 'priority'
+CONF_PROFILER = 'profiler'
 CONF_PROMETHEUS = 'prometheus'
 CONF_PROTOCOL = 'protocol'
 CONF_PULL_MODE = 'pull_mode'
 CONF_PULSE_LENGTH = 'pulse_length'
 CONF_QOS = 'qos'
+CONF_QUANTILE = 'quantile'
 CONF_RANDOM = 'random'
 CONF_RANGE = 'range'
 CONF_RANGE_FROM = 'range_from'
@@ -459,6 +463,7 @@ CONF_TARGET_TEMPERATURE_HIGH = 'target_temperature_high'
 CONF_TARGET_TEMPERATURE_LOW = 'target_temperature_low'
 CONF_TEMPERATURE = 'temperature'
 CONF_TEMPERATURE_STEP = 'temperature_step'
+CONF_TEXT_SENSOR = 'text_sensor'
 CONF_TEXT_SENSORS = 'text_sensors'
 CONF_THEN = 'then'
 CONF_THRESHOLD = 'threshold'
@@ -10,6 +10,9 @@ namespace esphome {
 
 static const char *TAG = "app";
 
+/// Maximum time the main loop sleeps when all looping components only loop on wakeups.
+static const uint32_t MAX_IDLE_SLEEP = 1000;
+
 void Application::register_component_(Component *comp) {
   if (comp == nullptr) {
     ESP_LOGW(TAG, "Tried to register null component!");
@@ -26,6 +29,9 @@ void Application::register_component_(Component *comp) {
 }
 void Application::setup() {
   ESP_LOGI(TAG, "Running through setup()...");
+#ifdef ARDUINO_ARCH_ESP32
+  this->loop_task_handle_ = xTaskGetCurrentTaskHandle();
+#endif
   ESP_LOGV(TAG, "Sorting components by setup priority...");
   std::stable_sort(this->components_.begin(), this->components_.end(), [](const Component *a, const Component *b) {
     return a->get_actual_setup_priority() > b->get_actual_setup_priority();
@@ -62,15 +68,20 @@ void Application::setup() {
 void Application::loop() {
   uint32_t new_app_state = 0;
   const uint32_t start = millis();
+  this->wake_requested_ = false;
 
   this->scheduler.call();
+  // Whether any looping component needs to be polled, instead of only looping on wakeups
+  bool polling = false;
   for (Component *component : this->looping_components_) {
     component->call();
     new_app_state |= component->get_component_state();
     this->app_state_ |= new_app_state;
     this->feed_wdt();
+    polling |= !component->is_loop_on_wakeup_only();
   }
   this->app_state_ = new_app_state;
+  global_preferences.loop();
 
   const uint32_t end = millis();
   if (end - start > 200) {
@@ -79,20 +90,29 @@ void Application::loop() {
   }
 
   const uint32_t now = millis();
+  // Keep dumping the config at the normal pace
+  polling |= this->dump_config_at_ >= 0 && this->dump_config_at_ < int(this->components_.size());
 
   if (HighFrequencyLoopRequester::is_high_frequency()) {
     yield();
   } else {
-    uint32_t delay_time = this->loop_interval_;
-    if (now - this->last_loop_ < this->loop_interval_)
-      delay_time = this->loop_interval_ - (now - this->last_loop_);
+    // Sleep until the next poll of the polling components or the next timeout/interval is due, whichever comes
+    // first. Without polling components only the scheduler (and wakeups) end the sleep.
+    uint32_t delay_time = MAX_IDLE_SLEEP;
+    if (polling) {
+      delay_time = this->loop_interval_;
+      if (now - this->last_loop_ < this->loop_interval_)
+        delay_time = this->loop_interval_ - (now - this->last_loop_);
+    }
 
     uint32_t next_schedule = this->scheduler.next_schedule_in().value_or(delay_time);
-    // next_schedule is max 0.5*delay_time
-    // otherwise interval=0 schedules result in constant looping with almost no sleep
-    next_schedule = std::max(next_schedule, delay_time / 2);
+    if (polling) {
+      // next_schedule is max 0.5*delay_time
+      // otherwise interval=0 schedules result in constant looping with almost no sleep
+      next_schedule = std::max(next_schedule, delay_time / 2);
+    }
     delay_time = std::min(next_schedule, delay_time);
-    delay(delay_time);
+    this->sleep_(delay_time);
   }
   this->last_loop_ = now;
 
@@ -106,6 +126,40 @@ void Application::loop() {
   }
 }
 
+void Application::sleep_(uint32_t delay_ms) {
+#ifdef ARDUINO_ARCH_ESP32
+  if (delay_ms == 0) {
+    yield();
+    return;
+  }
+  // Blocks until the timeout expires or wake_loop() notifies this task
+  ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(delay_ms));
+#else
+  // delay() can't be interrupted, so sleep in slices of at most one loop interval
+  do {
+    const uint32_t slice = this->loop_interval_ == 0 ? delay_ms : std::min(delay_ms, this->loop_interval_);
+    delay(slice);
+    delay_ms -= slice;
+  } while (delay_ms != 0 && !this->wake_requested_);
+#endif
+}
+
+void ICACHE_RAM_ATTR Application::wake_loop() {
+  this->wake_requested_ = true;
+#ifdef ARDUINO_ARCH_ESP32
+  if (this->loop_task_handle_ == nullptr)
+    return;
+  if (xPortInIsrContext()) {
+    BaseType_t higher_priority_task_woken = pdFALSE;
+    vTaskNotifyGiveFromISR(this->loop_task_handle_, &higher_priority_task_woken);
+    if (higher_priority_task_woken)
+      portYIELD_FROM_ISR();
+  } else {
+    xTaskNotifyGive(this->loop_task_handle_);
+  }
+#endif
+}
+
 void ICACHE_RAM_ATTR HOT Application::feed_wdt() {
   static uint32_t LAST_FEED = 0;
   uint32_t now = millis();
@@ -128,6 +182,7 @@ void Application::reboot() {
   ESP_LOGI(TAG, "Forcing a reboot...");
   for (auto *comp : this->components_)
     comp->on_shutdown();
+  global_preferences.sync();
   ESP.restart();
   // restart() doesn't always end execution
   while (true) {
@@ -140,6 +195,7 @@ void Application::safe_reboot() {
     comp->on_safe_shutdown();
   for (auto *comp : this->components_)
     comp->on_shutdown();
+  global_preferences.sync();
   ESP.restart();
   // restart() doesn't always end execution
   while (true) {
@@ -8,6 +8,11 @@
 #include "esphome/core/helpers.h"
 #include "esphome/core/scheduler.h"
 
+#ifdef ARDUINO_ARCH_ESP32
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#endif
+
 #ifdef USE_BINARY_SENSOR
 #include "esphome/components/binary_sensor/binary_sensor.h"
 #endif
@@ -112,6 +117,12 @@ class Application {
 
   void schedule_dump_config() { this->dump_config_at_ = 0; }
 
+  /** Wake up the main loop if it's currently sleeping. Safe to call from interrupts and other tasks.
+   *
+   * On the ESP32 the sleep ends immediately, on the ESP8266 it ends after at most one loop interval.
+   */
+  void wake_loop();
+
   void feed_wdt();
 
   void reboot();
@@ -125,10 +136,15 @@ class Application {
     for (auto *comp : this->components_) {
       comp->on_shutdown();
     }
+    global_preferences.sync();
   }
 
   uint32_t get_app_state() const { return this->app_state_; }
 
+#ifdef USE_PROFILER
+  const std::vector<Component *> &get_components() { return this->components_; }
+#endif
+
 #ifdef USE_BINARY_SENSOR
   const std::vector<binary_sensor::BinarySensor *> &get_binary_sensors() { return this->binary_sensors_; }
   binary_sensor::BinarySensor *get_binary_sensor_by_key(uint32_t key, bool include_internal = false) {
@@ -211,6 +227,9 @@ class Application {
 
   void calculate_looping_components_();
 
+  /// Sleep for at most delay_ms milliseconds, returning early if wake_loop() is called.
+  void sleep_(uint32_t delay_ms);
+
   std::vector<Component *> components_{};
   std::vector<Component *> looping_components_{};
 
@@ -245,6 +264,10 @@ class Application {
   uint32_t loop_interval_{16};
   int dump_config_at_{-1};
   uint32_t app_state_{0};
+  volatile bool wake_requested_{false};
+#ifdef ARDUINO_ARCH_ESP32
+  TaskHandle_t loop_task_handle_{nullptr};
+#endif
 };
 
 /// Global storage of Application pointer - only one Application can exist.
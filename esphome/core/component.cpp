@@ -3,6 +3,7 @@
 #include "esphome/core/esphal.h"
 #include "esphome/core/log.h"
 #include "esphome/core/application.h"
+#include <algorithm>
 
 namespace esphome {
 
@@ -34,6 +35,27 @@ const uint32_t STATUS_LED_ERROR = 0x0200;
 
 uint32_t global_state = 0;
 
+#ifdef USE_PROFILER
+const uint32_t PROFILE_STATS_BUCKET_LIMITS[PROFILE_STATS_BUCKETS - 1] = {100, 1000, 5000, 10000, 20000, 50000, 100000};
+
+void ProfileStats::record(uint32_t duration_us) {
+  this->count_++;
+  this->total_us_ += duration_us;
+  this->min_us_ = std::min(this->min_us_, duration_us);
+  this->max_us_ = std::max(this->max_us_, duration_us);
+  uint8_t i = 0;
+  while (i < PROFILE_STATS_BUCKETS - 1 && duration_us > PROFILE_STATS_BUCKET_LIMITS[i])
+    i++;
+  this->buckets_[i]++;
+}
+void ProfileStats::reset() { *this = ProfileStats(); }
+uint32_t ProfileStats::get_avg_us() const {
+  if (this->count_ == 0)
+    return 0;
+  return this->total_us_ / this->count_;
+}
+#endif
+
 float Component::get_loop_priority() const { return 0.0f; }
 
 float Component::get_setup_priority() const { return setup_priority::DATA; }
@@ -46,18 +68,34 @@ void Component::set_interval(const std::string &name, uint32_t interval, std::fu
   App.scheduler.set_interval(this, name, interval, std::move(f));
 }
 
+void Component::set_interval(const char *name, uint32_t interval, std::function<void()> &&f) {  // NOLINT
+  App.scheduler.set_interval(this, name, interval, std::move(f));
+}
+
 bool Component::cancel_interval(const std::string &name) {  // NOLINT
   return App.scheduler.cancel_interval(this, name);
 }
 
+bool Component::cancel_interval(const char *name) {  // NOLINT
+  return App.scheduler.cancel_interval(this, name);
+}
+
 void Component::set_timeout(const std::string &name, uint32_t timeout, std::function<void()> &&f) {  // NOLINT
   return App.scheduler.set_timeout(this, name, timeout, std::move(f));
 }
 
+void Component::set_timeout(const char *name, uint32_t timeout, std::function<void()> &&f) {  // NOLINT
+  App.scheduler.set_timeout(this, name, timeout, std::move(f));
+}
+
 bool Component::cancel_timeout(const std::string &name) {  // NOLINT
   return App.scheduler.cancel_timeout(this, name);
 }
 
+bool Component::cancel_timeout(const char *name) {  // NOLINT
+  return App.scheduler.cancel_timeout(this, name);
+}
+
 void Component::call_loop() { this->loop(); }
 
 void Component::call_setup() { this->setup(); }
@@ -77,10 +115,22 @@ void Component::call() {
       this->component_state_ |= COMPONENT_STATE_LOOP;
       this->call_loop();
       break;
-    case COMPONENT_STATE_LOOP:
-      // State loop: Call loop
+    case COMPONENT_STATE_LOOP: {
+      // State loop: Call loop, unless we only loop on wakeups and there was none
+      if (this->loop_on_wakeup_only_) {
+        if (!this->wakeup_pending_)
+          break;
+        this->wakeup_pending_ = false;
+      }
+#ifdef USE_PROFILER
+      const uint32_t start = micros();
       this->call_loop();
+      this->loop_stats_.record(micros() - start);
+#else
+      this->call_loop();
+#endif
       break;
+    }
     case COMPONENT_STATE_FAILED:
       // State failed: Do nothing
       break;
@@ -100,9 +150,15 @@ void Component::defer(std::function<void()> &&f) {  // NOLINT
 bool Component::cancel_defer(const std::string &name) {  // NOLINT
   return App.scheduler.cancel_timeout(this, name);
 }
+bool Component::cancel_defer(const char *name) {  // NOLINT
+  return App.scheduler.cancel_timeout(this, name);
+}
 void Component::defer(const std::string &name, std::function<void()> &&f) {  // NOLINT
   App.scheduler.set_timeout(this, name, 0, std::move(f));
 }
+void Component::defer(const char *name, std::function<void()> &&f) {  // NOLINT
+  App.scheduler.set_timeout(this, name, 0, std::move(f));
+}
 void Component::set_timeout(uint32_t timeout, std::function<void()> &&f) {  // NOLINT
   App.scheduler.set_timeout(this, "", timeout, std::move(f));
 }
@@ -127,10 +183,18 @@ void Component::status_momentary_warning(const std::string &name, uint32_t lengt
   this->status_set_warning();
   this->set_timeout(name, length, [this]() { this->status_clear_warning(); });
 }
+void Component::status_momentary_warning(const char *name, uint32_t length) {
+  this->status_set_warning();
+  this->set_timeout(name, length, [this]() { this->status_clear_warning(); });
+}
 void Component::status_momentary_error(const std::string &name, uint32_t length) {
   this->status_set_error();
   this->set_timeout(name, length, [this]() { this->status_clear_error(); });
 }
+void Component::status_momentary_error(const char *name, uint32_t length) {
+  this->status_set_error();
+  this->set_timeout(name, length, [this]() { this->status_clear_error(); });
+}
 void Component::dump_config() {}
 float Component::get_actual_setup_priority() const {
   if (isnan(this->setup_priority_override_))
@@ -139,6 +203,10 @@ float Component::get_actual_setup_priority() const {
 }
 void Component::set_setup_priority(float priority) { this->setup_priority_override_ = priority; }
 
+void ICACHE_RAM_ATTR Component::wakeup() {
+  this->wakeup_pending_ = true;
+  App.wake_loop();
+}
 bool Component::has_overridden_loop() const {
 #ifdef CLANG_TIDY
   bool loop_overridden = true;
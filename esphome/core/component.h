@@ -4,6 +4,7 @@
 #include <functional>
 #include "Arduino.h"
 
+#include "esphome/core/defines.h"
 #include "esphome/core/optional.h"
 
 namespace esphome {
@@ -53,6 +54,36 @@ extern const uint32_t STATUS_LED_OK;
 extern const uint32_t STATUS_LED_WARNING;
 extern const uint32_t STATUS_LED_ERROR;
 
+#ifdef USE_PROFILER
+/// Number of histogram buckets tracked by ProfileStats, the last bucket has no upper bound.
+static const uint8_t PROFILE_STATS_BUCKETS = 8;
+/// Inclusive upper bounds (in microseconds) of all but the last ProfileStats bucket.
+extern const uint32_t PROFILE_STATS_BUCKET_LIMITS[PROFILE_STATS_BUCKETS - 1];
+
+/// Fixed-size run time statistics of a single code path, used by the loop/scheduler profiler.
+class ProfileStats {
+ public:
+  /// Record one run that took duration_us microseconds.
+  void record(uint32_t duration_us);
+  void reset();
+
+  uint32_t get_count() const { return this->count_; }
+  uint32_t get_min_us() const { return this->count_ == 0 ? 0 : this->min_us_; }
+  uint32_t get_max_us() const { return this->max_us_; }
+  uint32_t get_avg_us() const;
+  uint64_t get_total_us() const { return this->total_us_; }
+  /// Number of runs in the given bucket (not cumulative).
+  uint32_t get_bucket(uint8_t index) const { return this->buckets_[index]; }
+
+ protected:
+  uint32_t count_{0};
+  uint32_t min_us_{UINT32_MAX};
+  uint32_t max_us_{0};
+  uint64_t total_us_{0};
+  uint32_t buckets_[PROFILE_STATS_BUCKETS]{};
+};
+#endif
+
 class Component {
  public:
   /** Where the component's initialization should happen.
@@ -123,11 +154,35 @@ class Component {
   void status_clear_error();
 
   void status_momentary_warning(const std::string &name, uint32_t length = 5000);
+  void status_momentary_warning(const char *name, uint32_t length = 5000);
 
   void status_momentary_error(const std::string &name, uint32_t length = 5000);
+  void status_momentary_error(const char *name, uint32_t length = 5000);
 
   bool has_overridden_loop() const;
 
+  /** Only call loop() after wakeup() was called, instead of in every main loop iteration.
+   *
+   * This is for components whose loop() only reacts to events like interrupts, timeouts and intervals
+   * are still run as usual. If all looping components do this, the main loop sleeps until the next
+   * scheduled timeout/interval or wakeup() instead of polling every loop interval.
+   */
+  void set_loop_on_wakeup_only(bool loop_on_wakeup_only) { this->loop_on_wakeup_only_ = loop_on_wakeup_only; }
+  bool is_loop_on_wakeup_only() const { return this->loop_on_wakeup_only_; }
+
+  /// Request a loop() call of this component and wake up the main loop. Safe to call from interrupts.
+  void wakeup();
+
+#ifdef USE_PROFILER
+  /// Set the identifier of this component shown by the profiler (the configuration ID).
+  void set_component_source(const char *source) { this->component_source_ = source; }
+  const char *get_component_source() const { return this->component_source_; }
+  /// Time spent in loop() of this component.
+  ProfileStats &get_loop_stats() { return this->loop_stats_; }
+  /// Time spent in timeouts/intervals scheduled by this component.
+  ProfileStats &get_scheduler_stats() { return this->scheduler_stats_; }
+#endif
+
  protected:
   virtual void call_loop();
   virtual void call_setup();
@@ -148,6 +203,12 @@ class Component {
    */
   void set_interval(const std::string &name, uint32_t interval, std::function<void()> &&f);  // NOLINT
 
+  /** Set an interval function with a static name (like a string literal).
+   *
+   * Same as above, but the name isn't copied so it must stay valid while the interval is set.
+   */
+  void set_interval(const char *name, uint32_t interval, std::function<void()> &&f);  // NOLINT
+
   void set_interval(uint32_t interval, std::function<void()> &&f);  // NOLINT
 
   /** Cancel an interval function.
@@ -156,6 +217,7 @@ class Component {
    * @return Whether an interval functions was deleted.
    */
   bool cancel_interval(const std::string &name);  // NOLINT
+  bool cancel_interval(const char *name);         // NOLINT
 
   void set_timeout(uint32_t timeout, std::function<void()> &&f);  // NOLINT
 
@@ -175,12 +237,19 @@ class Component {
    */
   void set_timeout(const std::string &name, uint32_t timeout, std::function<void()> &&f);  // NOLINT
 
+  /** Set a timeout function with a static name (like a string literal).
+   *
+   * Same as above, but the name isn't copied so it must stay valid while the timeout is set.
+   */
+  void set_timeout(const char *name, uint32_t timeout, std::function<void()> &&f);  // NOLINT
+
   /** Cancel a timeout function.
    *
    * @param name The identifier for this timeout function.
    * @return Whether a timeout functions was deleted.
    */
   bool cancel_timeout(const std::string &name);  // NOLINT
+  bool cancel_timeout(const char *name);         // NOLINT
 
   /** Defer a callback to the next loop() call.
    *
@@ -190,15 +259,24 @@ class Component {
    * @param f The callback.
    */
   void defer(const std::string &name, std::function<void()> &&f);  // NOLINT
+  void defer(const char *name, std::function<void()> &&f);         // NOLINT
 
   /// Defer a callback to the next loop() call.
   void defer(std::function<void()> &&f);  // NOLINT
 
   /// Cancel a defer callback using the specified name, name must not be empty.
   bool cancel_defer(const std::string &name);  // NOLINT
+  bool cancel_defer(const char *name);         // NOLINT
 
   uint32_t component_state_{0x0000};  ///< State of this component.
   float setup_priority_override_{NAN};
+  bool loop_on_wakeup_only_{false};
+  volatile bool wakeup_pending_{false};
+#ifdef USE_PROFILER
+  const char *component_source_{"unknown"};
+  ProfileStats loop_stats_;
+  ProfileStats scheduler_stats_;
+#endif
 };
 
 /** This class simplifies creating components that periodically check a state.
@@ -3,6 +3,7 @@
 
 #define USE_API
 #define USE_LOGGER
+#define USE_PROFILER
 #define USE_BINARY_SENSOR
 #define USE_SENSOR
 #define USE_SWITCH
@@ -313,6 +313,64 @@ template<typename T> class Parented {
   T *parent_{nullptr};
 };
 
+/** A ring buffer with a fixed capacity that is allocated once.
+ *
+ * Pushing into a full buffer overwrites the oldest element. Unlike std::queue and std::deque, it never allocates
+ * after set_capacity(), so long-running sliding windows don't fragment the heap.
+ */
+template<typename T> class RingBuffer {
+ public:
+  RingBuffer() = default;
+  explicit RingBuffer(size_t capacity) { this->set_capacity(capacity); }
+
+  /// Allocate room for capacity elements. All current elements are dropped.
+  void set_capacity(size_t capacity) {
+    std::vector<T>(capacity).swap(this->data_);
+    this->clear();
+  }
+  /// Append value, overwriting the oldest element if the buffer is full.
+  void push(const T &value) {
+    if (this->full()) {
+      this->data_[this->head_] = value;
+      this->head_ = (this->head_ + 1) % this->data_.size();
+    } else {
+      this->data_[(this->head_ + this->size_) % this->data_.size()] = value;
+      this->size_++;
+    }
+  }
+  /// Remove the oldest element. The buffer must not be empty.
+  void pop() {
+    // Release whatever the element holds instead of keeping it alive until the slot is overwritten
+    this->data_[this->head_] = T();
+    this->head_ = (this->head_ + 1) % this->data_.size();
+    this->size_--;
+  }
+  void clear() {
+    this->head_ = 0;
+    this->size_ = 0;
+  }
+
+  /// Access elements from oldest (0) to newest (size() - 1).
+  T &operator[](size_t index) { return this->data_[(this->head_ + index) % this->data_.size()]; }
+  const T &operator[](size_t index) const { return this->data_[(this->head_ + index) % this->data_.size()]; }
+  /// The oldest element, which is the next one to be overwritten.
+  T &front() { return this->data_[this->head_]; }
+  /// The newest element.
+  T &back() { return (*this)[this->size_ - 1]; }
+
+  size_t size() const { return this->size_; }
+  size_t capacity() const { return this->data_.size(); }
+  bool empty() const { return this->size_ == 0; }
+  bool full() const { return this->size_ == this->data_.size(); }
+
+ protected:
+  std::vector<T> data_;
+  size_t head_{0};
+  size_t size_{0};
+};
+
 uint32_t fnv1_hash(const std::string &str);
+uint32_t fnv1_hash(const char *str);
+uint32_t fnv1_hash(const uint8_t *data, size_t len);
 
 }  // namespace esphome
@@ -0,0 +1,249 @@
+#include "esphome/core/preference_log.h"
+#include "esphome/core/log.h"
+
+#if !defined(ARDUINO_ARCH_ESP8266) && !defined(ARDUINO_ARCH_ESP32)
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace esphome {
+
+static const char *TAG = "preferences";
+
+const uint32_t PreferenceLog::MAGIC;
+const uint32_t PreferenceLog::RECORD_OVERHEAD;
+const uint32_t PreferenceLog::ERASED;
+
+PreferenceLog::PreferenceLog(PreferenceLogStorage *storage, uint32_t max_record_words)
+    : storage_(storage), max_record_words_(max_record_words), write_position_(storage->size_words()) {}
+
+uint32_t PreferenceLog::checksum_(const uint32_t *record, size_t length_words) {
+  uint32_t checksum = 2166136261UL;
+  for (size_t i = 0; i < length_words; i++)
+    checksum = (checksum ^ record[i]) * 16777619UL;
+  return checksum;
+}
+
+bool PreferenceLog::has_magic() {
+  uint32_t magic;
+  return this->storage_->read(0, &magic, 1) && magic == MAGIC;
+}
+
+bool PreferenceLog::load() {
+  const uint32_t size = this->storage_->size_words();
+  this->index_.clear();
+  // Until the log is known to be intact, every write has to start over with an erase
+  this->write_position_ = size;
+
+  std::vector<uint32_t> record(this->max_record_words_ + RECORD_OVERHEAD);
+  uint32_t position = 1;
+  while (position + RECORD_OVERHEAD <= size) {
+    if (!this->storage_->read(position, record.data(), 2))
+      return false;
+    if (record[0] == ERASED)
+      break;
+
+    uint32_t length = record[1] & 0xFFFF;
+    uint32_t total = length + RECORD_OVERHEAD;
+    if (length > this->max_record_words_ || position + total > size) {
+      // The record header itself is damaged, so the rest of the log can't be parsed
+      ESP_LOGW(TAG, "Corrupt preference record header at word %u!", position);
+      return false;
+    }
+    if (!this->storage_->read(position + 2, &record[2], length + 1))
+      return false;
+
+    if (record[total - 1] != checksum_(record.data(), total - 1)) {
+      // Most likely a save interrupted by a power loss, the previous record of this preference stays valid
+      ESP_LOGW(TAG, "Skipping preference record with invalid checksum at word %u", position);
+      position += total;
+      continue;
+    }
+
+    this->update_index_(record[0], record[1] >> 16, length, position);
+    position += total;
+  }
+
+  this->write_position_ = position;
+  return true;
+}
+
+const PreferenceLog::IndexEntry *PreferenceLog::find(uint32_t type, uint16_t instance) const {
+  for (auto &entry : this->index_) {
+    if (entry.type == type && entry.instance == instance)
+      return &entry;
+  }
+  return nullptr;
+}
+
+bool PreferenceLog::read_data(const IndexEntry &entry, uint32_t *dest) {
+  return this->storage_->read(entry.position + 2, dest, entry.length_words);
+}
+
+size_t PreferenceLog::records_size_(const std::vector<Record> &records) {
+  size_t size = 0;
+  for (auto &record : records)
+    size += record.length_words + RECORD_OVERHEAD;
+  return size;
+}
+
+bool PreferenceLog::can_append(const std::vector<Record> &records) const {
+  return this->write_position_ + records_size_(records) <= this->storage_->size_words();
+}
+
+void PreferenceLog::encode_(std::vector<uint32_t> &buffer, const std::vector<Record> &records, uint32_t base) {
+  this->encoded_index_.clear();
+  buffer.reserve(buffer.size() + records_size_(records));
+  for (auto &record : records) {
+    const size_t start = buffer.size();
+    buffer.push_back(record.type);
+    buffer.push_back(uint32_t(record.instance) << 16 | record.length_words);
+    buffer.insert(buffer.end(), record.data, record.data + record.length_words);
+    buffer.push_back(checksum_(&buffer[start], record.length_words + 2));
+    this->encoded_index_.push_back(
+        IndexEntry{record.type, record.instance, record.length_words, uint16_t(base + start)});
+  }
+}
+
+void PreferenceLog::update_index_(uint32_t type, uint16_t instance, uint16_t length_words, uint16_t position) {
+  for (auto &entry : this->index_) {
+    if (entry.type == type && entry.instance == instance) {
+      entry.length_words = length_words;
+      entry.position = position;
+      return;
+    }
+  }
+  this->index_.push_back(IndexEntry{type, instance, length_words, position});
+}
+
+bool PreferenceLog::append(const std::vector<Record> &records) {
+  std::vector<uint32_t> buffer;
+  this->encode_(buffer, records, this->write_position_);
+  if (buffer.empty())
+    return true;
+
+  ESP_LOGVV(TAG, "Appending %u preference words at word %u...", buffer.size(), this->write_position_);
+  if (!this->storage_->write(this->write_position_, buffer.data(), buffer.size())) {
+    ESP_LOGV(TAG, "Writing preference storage failed!");
+    // The region may be partially written, start from a freshly erased storage next time
+    this->write_position_ = this->storage_->size_words();
+    return false;
+  }
+
+  this->write_position_ += buffer.size();
+  for (auto &entry : this->encoded_index_)
+    this->update_index_(entry.type, entry.instance, entry.length_words, entry.position);
+  return true;
+}
+
+bool PreferenceLog::compact(const std::vector<Record> &records) {
+  ESP_LOGV(TAG, "Compacting preferences...");
+  const uint32_t size = this->storage_->size_words();
+  std::vector<uint32_t> buffer;
+  buffer.push_back(MAGIC);
+  this->encode_(buffer, records, 0);
+
+  // Until a compaction succeeds, every write has to start over with an erase
+  this->write_position_ = size;
+  if (buffer.size() > size) {
+    ESP_LOGW(TAG, "Preferences don't fit into the storage (%u > %u words)!", buffer.size(), size);
+    return false;
+  }
+  if (!this->storage_->erase()) {
+    ESP_LOGV(TAG, "Erasing preference storage failed!");
+    return false;
+  }
+  this->index_.clear();
+  // The magic is written first, so that after a power loss the records written up to then are restored
+  if (!this->storage_->write(0, buffer.data(), buffer.size())) {
+    ESP_LOGV(TAG, "Writing preference storage failed!");
+    return false;
+  }
+
+  this->write_position_ = buffer.size();
+  for (auto &entry : this->encoded_index_)
+    this->update_index_(entry.type, entry.instance, entry.length_words, entry.position);
+  return true;
+}
+
+#if !defined(ARDUINO_ARCH_ESP8266) && !defined(ARDUINO_ARCH_ESP32)
+MmapPreferenceLogStorage::MmapPreferenceLogStorage(std::string path, uint32_t size_words)
+    : path_(std::move(path)), size_words_(size_words) {}
+MmapPreferenceLogStorage::~MmapPreferenceLogStorage() { this->close(); }
+
+bool MmapPreferenceLogStorage::open() {
+  this->fd_ = ::open(this->path_.c_str(), O_RDWR | O_CREAT, 0644);
+  if (this->fd_ < 0) {
+    ESP_LOGE(TAG, "Opening '%s' failed: %s", this->path_.c_str(), strerror(errno));
+    return false;
+  }
+  struct stat st {};
+  const size_t size = size_t(this->size_words_) * 4;
+  if (fstat(this->fd_, &st) != 0 || ftruncate(this->fd_, size) != 0) {
+    ESP_LOGE(TAG, "Resizing '%s' failed: %s", this->path_.c_str(), strerror(errno));
+    this->close();
+    return false;
+  }
+  void *data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, this->fd_, 0);
+  if (data == MAP_FAILED) {
+    ESP_LOGE(TAG, "Mapping '%s' failed: %s", this->path_.c_str(), strerror(errno));
+    this->close();
+    return false;
+  }
+  this->data_ = static_cast<uint32_t *>(data);
+
+  // A new (or grown) file is zero-filled, but the log expects erased words
+  const size_t old_size = size_t(st.st_size) < size ? size_t(st.st_size) & ~size_t(3) : size;
+  if (old_size < size) {
+    memset(reinterpret_cast<uint8_t *>(this->data_) + old_size, 0xFF, size - old_size);
+    return this->sync_(old_size / 4, (size - old_size) / 4);
+  }
+  return true;
+}
+void MmapPreferenceLogStorage::close() {
+  if (this->data_ != nullptr) {
+    munmap(this->data_, size_t(this->size_words_) * 4);
+    this->data_ = nullptr;
+  }
+  if (this->fd_ >= 0) {
+    ::close(this->fd_);
+    this->fd_ = -1;
+  }
+}
+bool MmapPreferenceLogStorage::read(uint32_t position, uint32_t *dest, size_t length_words) {
+  if (this->data_ == nullptr || position + length_words > this->size_words_)
+    return false;
+  memcpy(dest, &this->data_[position], length_words * 4);
+  return true;
+}
+bool MmapPreferenceLogStorage::write(uint32_t position, const uint32_t *src, size_t length_words) {
+  if (this->data_ == nullptr || position + length_words > this->size_words_)
+    return false;
+  for (size_t i = 0; i < length_words; i++)
+    this->data_[position + i] &= src[i];
+  return this->sync_(position, length_words);
+}
+bool MmapPreferenceLogStorage::erase() {
+  if (this->data_ == nullptr)
+    return false;
+  memset(this->data_, 0xFF, size_t(this->size_words_) * 4);
+  return this->sync_(0, this->size_words_);
+}
+bool MmapPreferenceLogStorage::sync_(uint32_t position, size_t length_words) {
+  // msync() needs a page aligned start address
+  const uintptr_t page_size = sysconf(_SC_PAGESIZE);
+  const uintptr_t start = reinterpret_cast<uintptr_t>(&this->data_[position]);
+  const uintptr_t aligned = start & ~(page_size - 1);
+  if (msync(reinterpret_cast<void *>(aligned), start - aligned + length_words * 4, MS_SYNC) != 0) {
+    ESP_LOGE(TAG, "Syncing '%s' failed: %s", this->path_.c_str(), strerror(errno));
+    return false;
+  }
+  return true;
+}
+#endif
+
+}  // namespace esphome
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace esphome {
+
+/// A single erasable sector of 32 bit words that a PreferenceLog is kept in. Erased words read as 0xFFFFFFFF.
+class PreferenceLogStorage {
+ public:
+  virtual uint32_t size_words() const = 0;
+  virtual bool read(uint32_t position, uint32_t *dest, size_t length_words) = 0;
+  virtual bool write(uint32_t position, const uint32_t *src, size_t length_words) = 0;
+  virtual bool erase() = 0;
+};
+
+/** An append-only log of preference records, so saving a preference doesn't need a sector erase until the
+ * storage is full. The first word of the storage is PreferenceLog::MAGIC, followed by records of the form:
+ *
+ *  - the preference type
+ *  - the instance number in the upper and the data length in words in the lower 16 bits
+ *  - the preference data (including its CRC word)
+ *  - a checksum over all previous words of the record
+ *
+ * The newest valid record of a preference wins. A record with a bad checksum (a save interrupted by a power
+ * loss) is skipped, so the previous record of that preference stays valid. When the storage is full, it is
+ * erased and only the latest record of every preference is written back (compact()).
+ *
+ * Preferences sharing a type are told apart by their instance number.
+ */
+class PreferenceLog {
+ public:
+  static const uint32_t MAGIC = 0x50524601;  // "PRF", version 1
+  static const uint32_t RECORD_OVERHEAD = 3;
+  static const uint32_t ERASED = 0xFFFFFFFF;
+
+  /// Position of the newest valid record of a preference, found in load() and kept up to date by writes.
+  struct IndexEntry {
+    uint32_t type;
+    uint16_t instance;
+    uint16_t length_words;
+    uint16_t position;
+  };
+  /// A record to write, data points to length_words words.
+  struct Record {
+    uint32_t type;
+    uint16_t instance;
+    uint16_t length_words;
+    const uint32_t *data;
+  };
+
+  /**
+   * @param storage The storage the log is kept in, at most 65535 words.
+   * @param max_record_words The longest record data in words, longer records are treated as a damaged header.
+   */
+  PreferenceLog(PreferenceLogStorage *storage, uint32_t max_record_words);
+
+  /// Whether the storage starts with MAGIC. If not, it's erased or holds a plain image from older versions.
+  bool has_magic();
+  /** Scan the log and index the newest valid record of every preference.
+   *
+   * Returns false if a damaged record header stopped the scan. The records found up to there are kept, and the
+   * next write compacts the log.
+   */
+  bool load();
+  /// Find the newest record of a preference, nullptr if there is none.
+  const IndexEntry *find(uint32_t type, uint16_t instance) const;
+  /// Read the data of an indexed record into dest, which has room for entry.length_words words.
+  bool read_data(const IndexEntry &entry, uint32_t *dest);
+
+  /// Whether the records can be appended without compacting the log first.
+  bool can_append(const std::vector<Record> &records) const;
+  /// Append the records, can_append() has to be true. On failure, the next write has to compact().
+  bool append(const std::vector<Record> &records);
+  /// Erase the storage and write the log with only the given records, the latest of every preference.
+  bool compact(const std::vector<Record> &records);
+
+  const std::vector<IndexEntry> &get_index() const { return this->index_; }
+  /// Word position where the next record is appended.
+  uint32_t get_write_position() const { return this->write_position_; }
+
+ protected:
+  static uint32_t checksum_(const uint32_t *record, size_t length_words);
+  static size_t records_size_(const std::vector<Record> &records);
+  /// Encode the records into buffer, which starts at word position base of the storage.
+  void encode_(std::vector<uint32_t> &buffer, const std::vector<Record> &records, uint32_t base);
+  void update_index_(uint32_t type, uint16_t instance, uint16_t length_words, uint16_t position);
+
+  PreferenceLogStorage *storage_;
+  uint32_t max_record_words_;
+  std::vector<IndexEntry> index_;
+  /// Index entries of the records in the last encoded buffer, only applied once the buffer is written.
+  std::vector<IndexEntry> encoded_index_;
+  uint32_t write_position_;
+};
+
+#if !defined(ARDUINO_ARCH_ESP8266) && !defined(ARDUINO_ARCH_ESP32)
+/** Keeps a PreferenceLog in a file that is mapped into memory, for POSIX host builds.
+ *
+ * Writes behave like NOR flash: they can only clear bits, so writing over a word that wasn't erased leaves
+ * the AND of both values, just like on the devices. Every write and erase is synced to the file.
+ */
+class MmapPreferenceLogStorage : public PreferenceLogStorage {
+ public:
+  MmapPreferenceLogStorage(std::string path, uint32_t size_words);
+  ~MmapPreferenceLogStorage();
+
+  /// Open (and if needed create) the file, a new file starts out erased.
+  bool open();
+  void close();
+
+  uint32_t size_words() const override { return this->size_words_; }
+  bool read(uint32_t position, uint32_t *dest, size_t length_words) override;
+  bool write(uint32_t position, const uint32_t *src, size_t length_words) override;
+  bool erase() override;
+
+ protected:
+  bool sync_(uint32_t position, size_t length_words);
+
+  std::string path_;
+  uint32_t size_words_;
+  int fd_{-1};
+  uint32_t *data_{nullptr};
+};
+#endif
+
+}  // namespace esphome
@@ -73,8 +73,6 @@ static inline bool esp_rtc_user_mem_read(uint32_t index, uint32_t *dest) {
   return true;
 }
 
-static bool esp8266_flash_dirty = false;
-
 static inline bool esp_rtc_user_mem_write(uint32_t index, uint32_t value) {
   if (index >= ESP_RTC_USER_MEM_SIZE_WORDS) {
     return false;
@@ -100,33 +98,75 @@ static const uint32_t get_esp8266_flash_sector() {
 }
 static const uint32_t get_esp8266_flash_address() { return get_esp8266_flash_sector() * SPI_FLASH_SEC_SIZE; }
 
-void ESPPreferences::save_esp8266_flash_() {
-  if (!esp8266_flash_dirty)
-    return;
-
-  ESP_LOGVV(TAG, "Saving preferences to flash...");
-  SpiFlashOpResult erase_res, write_res = SPI_FLASH_RESULT_OK;
-  {
+/// The preference flash sector, the flash preferences are kept in it as a PreferenceLog.
+class ESP8266FlashPreferenceStorage : public PreferenceLogStorage {
+ public:
+  uint32_t size_words() const override { return SPI_FLASH_SEC_SIZE / 4; }
+  bool read(uint32_t position, uint32_t *dest, size_t length_words) override {
     InterruptLock lock;
-    erase_res = spi_flash_erase_sector(get_esp8266_flash_sector());
-    if (erase_res == SPI_FLASH_RESULT_OK) {
-      write_res = spi_flash_write(get_esp8266_flash_address(), this->flash_storage_, ESP8266_FLASH_STORAGE_SIZE * 4);
-    }
+    return spi_flash_read(get_esp8266_flash_address() + position * 4, dest, length_words * 4) ==
+           SPI_FLASH_RESULT_OK;
   }
-  if (erase_res != SPI_FLASH_RESULT_OK) {
-    ESP_LOGV(TAG, "Erase ESP8266 flash failed!");
-    return;
+  bool write(uint32_t position, const uint32_t *src, size_t length_words) override {
+    InterruptLock lock;
+    return spi_flash_write(get_esp8266_flash_address() + position * 4, const_cast<uint32_t *>(src),
+                           length_words * 4) == SPI_FLASH_RESULT_OK;
   }
-  if (write_res != SPI_FLASH_RESULT_OK) {
-    ESP_LOGV(TAG, "Write ESP8266 flash failed!");
-    return;
+  bool erase() override {
+    InterruptLock lock;
+    return spi_flash_erase_sector(get_esp8266_flash_sector()) == SPI_FLASH_RESULT_OK;
+  }
+};
+
+static ESP8266FlashPreferenceStorage esp8266_flash_preference_storage;
+
+PreferenceLog::Record ESPPreferences::make_esp8266_flash_record_(const FlashPreference &pref) const {
+  return PreferenceLog::Record{pref.type, pref.instance, pref.length_words, &this->flash_storage_[pref.offset]};
+}
+
+bool ESPPreferences::append_esp8266_flash_records_() {
+  if (this->flash_legacy_image_)
+    return this->compact_esp8266_flash_();
+
+  std::vector<PreferenceLog::Record> records;
+  for (auto &pref : this->flash_preferences_) {
+    if (pref.dirty)
+      records.push_back(this->make_esp8266_flash_record_(pref));
   }
+  if (records.empty())
+    return true;
+  if (!this->flash_log_->can_append(records))
+    return this->compact_esp8266_flash_();
+  if (!this->flash_log_->append(records))
+    return false;
 
-  esp8266_flash_dirty = false;
+  for (auto &pref : this->flash_preferences_) {
+    pref.stored |= pref.dirty;
+    pref.dirty = false;
+  }
+  return true;
+}
+
+bool ESPPreferences::compact_esp8266_flash_() {
+  std::vector<PreferenceLog::Record> records;
+  for (auto &pref : this->flash_preferences_) {
+    if (pref.stored || pref.dirty)
+      records.push_back(this->make_esp8266_flash_record_(pref));
+  }
+  if (!this->flash_log_->compact(records))
+    return false;
+
+  this->flash_legacy_image_ = false;
+  for (auto &pref : this->flash_preferences_) {
+    pref.stored |= pref.dirty;
+    pref.dirty = false;
+  }
+  return true;
 }
 
 bool ESPPreferenceObject::save_internal_() {
   if (this->in_flash_) {
+    bool changed = false;
     for (uint32_t i = 0; i <= this->length_words_; i++) {
       uint32_t j = this->offset_ + i;
       if (j >= ESP8266_FLASH_STORAGE_SIZE)
@@ -134,11 +174,19 @@ bool ESPPreferenceObject::save_internal_() {
       uint32_t v = this->data_[i];
       uint32_t *ptr = &global_preferences.flash_storage_[j];
       if (*ptr != v)
-        esp8266_flash_dirty = true;
+        changed = true;
       *ptr = v;
     }
-    global_preferences.save_esp8266_flash_();
-    return true;
+    if (!changed)
+      return true;
+
+    for (auto &pref : global_preferences.flash_preferences_) {
+      if (pref.offset == this->offset_) {
+        pref.dirty = true;
+        break;
+      }
+    }
+    return global_preferences.mark_pending_();
   }
 
   for (uint32_t i = 0; i <= this->length_words_; i++) {
@@ -174,12 +222,21 @@ ESPPreferences::ESPPreferences()
 
 void ESPPreferences::begin() {
   this->flash_storage_ = new uint32_t[ESP8266_FLASH_STORAGE_SIZE];
+  this->flash_log_ = new PreferenceLog(&esp8266_flash_preference_storage, ESP8266_FLASH_STORAGE_SIZE);
   ESP_LOGVV(TAG, "Loading preferences from flash...");
 
-  {
-    InterruptLock lock;
-    spi_flash_read(get_esp8266_flash_address(), this->flash_storage_, ESP8266_FLASH_STORAGE_SIZE * 4);
+  esp8266_flash_preference_storage.read(0, this->flash_storage_, ESP8266_FLASH_STORAGE_SIZE);
+
+  if (this->flash_storage_[0] != PreferenceLog::MAGIC) {
+    // Plain image from an older version (or an erased sector): keep restoring from it,
+    // the first commit converts the sector to the log format.
+    this->flash_legacy_image_ = true;
+    return;
   }
+
+  // On failure everything read so far is kept, the next commit rewrites the sector
+  this->flash_log_->load();
+  ESP_LOGVV(TAG, "Loaded %u preference records from flash", this->flash_log_->get_index().size());
 }
 
 ESPPreferenceObject ESPPreferences::make_preference(size_t length, uint32_t type, bool in_flash) {
@@ -191,6 +248,24 @@ ESPPreferenceObject ESPPreferences::make_preference(size_t length, uint32_t type
     auto pref = ESPPreferenceObject(start, length, type);
     pref.in_flash_ = true;
     this->current_flash_offset_ = end;
+
+    FlashPreference flash_pref{};
+    flash_pref.type = type;
+    flash_pref.offset = start;
+    flash_pref.length_words = length + 1;
+    flash_pref.stored = this->flash_legacy_image_;
+    for (auto &other : this->flash_preferences_) {
+      if (other.type == type)
+        flash_pref.instance++;
+    }
+
+    if (!this->flash_legacy_image_) {
+      memset(&this->flash_storage_[start], 0, flash_pref.length_words * 4);
+      const PreferenceLog::IndexEntry *entry = this->flash_log_->find(type, flash_pref.instance);
+      if (entry != nullptr && entry->length_words == flash_pref.length_words)
+        flash_pref.stored = this->flash_log_->read_data(*entry, &this->flash_storage_[start]);
+    }
+    this->flash_preferences_.push_back(flash_pref);
     return pref;
   }
 
@@ -231,28 +306,34 @@ bool ESPPreferenceObject::save_internal_() {
   if (global_preferences.nvs_handle_ == 0)
     return false;
 
-  char key[32];
-  sprintf(key, "%u", this->offset_);
-  uint32_t len = (this->length_words_ + 1) * 4;
-  esp_err_t err = nvs_set_blob(global_preferences.nvs_handle_, key, this->data_, len);
-  if (err) {
-    ESP_LOGV(TAG, "nvs_set_blob('%s', len=%u) failed: %s", key, len, esp_err_to_name(err));
-    return false;
-  }
-  err = nvs_commit(global_preferences.nvs_handle_);
-  if (err) {
-    ESP_LOGV(TAG, "nvs_commit('%s', len=%u) failed: %s", key, len, esp_err_to_name(err));
-    return false;
+  std::vector<uint32_t> data(this->data_, this->data_ + this->length_words_ + 1);
+  bool found = false;
+  for (auto &pending : global_preferences.pending_saves_) {
+    if (pending.key == this->offset_) {
+      pending.data = std::move(data);
+      found = true;
+      break;
+    }
   }
-  return true;
+  if (!found)
+    global_preferences.pending_saves_.push_back(ESPPreferences::PendingSave{uint32_t(this->offset_), std::move(data)});
+  return global_preferences.mark_pending_();
 }
 bool ESPPreferenceObject::load_internal_() {
   if (global_preferences.nvs_handle_ == 0)
     return false;
 
+  uint32_t len = (this->length_words_ + 1) * 4;
+  for (auto &pending : global_preferences.pending_saves_) {
+    if (pending.key == this->offset_ && pending.data.size() * 4 == len) {
+      // Saved but not committed yet
+      memcpy(this->data_, pending.data.data(), len);
+      return true;
+    }
+  }
+
   char key[32];
   sprintf(key, "%u", this->offset_);
-  uint32_t len = (this->length_words_ + 1) * 4;
 
   uint32_t actual_len;
   esp_err_t err = nvs_get_blob(global_preferences.nvs_handle_, key, nullptr, &actual_len);
@@ -294,6 +375,59 @@ ESPPreferenceObject ESPPreferences::make_preference(size_t length, uint32_t type
   return pref;
 }
 #endif
+void ESPPreferences::set_commit_delay(uint32_t commit_delay) { this->commit_delay_ = commit_delay; }
+bool ESPPreferences::mark_pending_() {
+  if (!this->has_pending_) {
+    this->has_pending_ = true;
+    this->pending_since_ = millis();
+  }
+  if (this->commit_delay_ == 0)
+    return this->sync();
+  return true;
+}
+void ESPPreferences::loop() {
+  if (this->has_pending_ && millis() - this->pending_since_ >= this->commit_delay_)
+    this->sync();
+}
+bool ESPPreferences::sync() {
+  if (!this->has_pending_)
+    return true;
+
+  bool success = true;
+#ifdef ARDUINO_ARCH_ESP8266
+  success = this->append_esp8266_flash_records_();
+#endif
+#ifdef ARDUINO_ARCH_ESP32
+  ESP_LOGVV(TAG, "Committing %u preferences to NVS...", this->pending_saves_.size());
+  for (auto &pending : this->pending_saves_) {
+    char key[32];
+    sprintf(key, "%u", pending.key);
+    uint32_t len = pending.data.size() * 4;
+    esp_err_t err = nvs_set_blob(this->nvs_handle_, key, pending.data.data(), len);
+    if (err) {
+      ESP_LOGV(TAG, "nvs_set_blob('%s', len=%u) failed: %s", key, len, esp_err_to_name(err));
+      success = false;
+    }
+  }
+  if (success) {
+    esp_err_t err = nvs_commit(this->nvs_handle_);
+    if (err) {
+      ESP_LOGV(TAG, "nvs_commit() failed: %s", esp_err_to_name(err));
+      success = false;
+    }
+  }
+  if (success)
+    this->pending_saves_.clear();
+#endif
+
+  if (success) {
+    this->has_pending_ = false;
+  } else {
+    // Retry once the commit delay has passed again
+    this->pending_since_ = millis();
+  }
+  return success;
+}
 uint32_t ESPPreferenceObject::calculate_crc_() const {
   uint32_t crc = this->type_;
   for (size_t i = 0; i < this->length_words_; i++) {
@@ -1,9 +1,11 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include "esphome/core/esphal.h"
 #include "esphome/core/defines.h"
+#include "esphome/core/preference_log.h"
 
 namespace esphome {
 
@@ -68,18 +70,62 @@ class ESPPreferences {
   bool is_prevent_write();
 #endif
 
+  /** Set how long flash saves are held back before they are committed.
+   *
+   * Saves arriving within this window are coalesced and written in a single flash operation.
+   * Pending saves are always committed before a reboot or deep sleep.
+   *
+   * @param commit_delay The commit delay in milliseconds, 0 commits every save immediately.
+   */
+  void set_commit_delay(uint32_t commit_delay);
+
+  /// Commit all pending flash saves now. Returns false if writing to flash failed.
+  bool sync();
+
+  /// Commit pending flash saves once the commit delay has passed. Called from the main loop.
+  void loop();
+
  protected:
   friend ESPPreferenceObject;
 
+  bool mark_pending_();
+
   uint32_t current_offset_;
+  uint32_t commit_delay_{0};
+  uint32_t pending_since_{0};
+  bool has_pending_{false};
 #ifdef ARDUINO_ARCH_ESP32
+  struct PendingSave {
+    uint32_t key;
+    std::vector<uint32_t> data;
+  };
+
   uint32_t nvs_handle_;
+  std::vector<PendingSave> pending_saves_;
 #endif
 #ifdef ARDUINO_ARCH_ESP8266
-  void save_esp8266_flash_();
+  /// A preference kept in the flash log. Preferences sharing a type are told apart by their instance number.
+  struct FlashPreference {
+    uint32_t type;
+    uint16_t instance;
+    uint16_t offset;
+    uint16_t length_words;
+    bool stored;
+    bool dirty;
+  };
+
+  PreferenceLog::Record make_esp8266_flash_record_(const FlashPreference &pref) const;
+  bool append_esp8266_flash_records_();
+  bool compact_esp8266_flash_();
+
   bool prevent_write_{false};
   uint32_t *flash_storage_;
   uint32_t current_flash_offset_;
+  std::vector<FlashPreference> flash_preferences_;
+  /// The preference flash sector as an append-only log of records.
+  PreferenceLog *flash_log_{nullptr};
+  /// Whether the flash sector still holds the plain image written by older versions.
+  bool flash_legacy_image_{false};
 #endif
 };
 
@@ -8,42 +8,58 @@ namespace esphome {
 static const char *TAG = "scheduler";
 
 static const uint32_t SCHEDULER_DONT_RUN = 4294967295UL;
+static const size_t SCHEDULER_MAX_FREE_ITEMS = 8;
 
 // Uncomment to debug scheduler
 // #define ESPHOME_DEBUG_SCHEDULER
 
 void HOT Scheduler::set_timeout(Component *component, const std::string &name, uint32_t timeout,
                                 std::function<void()> &&func) {
+  this->set_timeout_(component, name.c_str(), false, timeout, std::move(func));
+}
+void HOT Scheduler::set_timeout(Component *component, const char *name, uint32_t timeout,
+                                std::function<void()> &&func) {
+  this->set_timeout_(component, name, true, timeout, std::move(func));
+}
+void HOT Scheduler::set_timeout_(Component *component, const char *name, bool static_name, uint32_t timeout,
+                                 std::function<void()> &&func) {
   const uint32_t now = this->millis_();
 
-  if (!name.empty())
-    this->cancel_timeout(component, name);
+  this->cancel_item_(component, name, SchedulerItem::TIMEOUT);
 
   if (timeout == SCHEDULER_DONT_RUN)
     return;
 
-  ESP_LOGVV(TAG, "set_timeout(name='%s', timeout=%u)", name.c_str(), timeout);
+  ESP_LOGVV(TAG, "set_timeout(name='%s', timeout=%u)", name, timeout);
 
-  auto item = make_unique<SchedulerItem>();
-  item->component = component;
-  item->name = name;
+  auto item = this->make_item_(component, name, static_name);
   item->type = SchedulerItem::TIMEOUT;
   item->timeout = timeout;
   item->last_execution = now;
   item->last_execution_major = this->millis_major_;
   item->f = std::move(func);
-  item->remove = false;
+  this->index_item_(item.get());
   this->push_(std::move(item));
 }
 bool HOT Scheduler::cancel_timeout(Component *component, const std::string &name) {
+  return this->cancel_item_(component, name.c_str(), SchedulerItem::TIMEOUT);
+}
+bool HOT Scheduler::cancel_timeout(Component *component, const char *name) {
   return this->cancel_item_(component, name, SchedulerItem::TIMEOUT);
 }
 void HOT Scheduler::set_interval(Component *component, const std::string &name, uint32_t interval,
                                  std::function<void()> &&func) {
+  this->set_interval_(component, name.c_str(), false, interval, std::move(func));
+}
+void HOT Scheduler::set_interval(Component *component, const char *name, uint32_t interval,
+                                 std::function<void()> &&func) {
+  this->set_interval_(component, name, true, interval, std::move(func));
+}
+void HOT Scheduler::set_interval_(Component *component, const char *name, bool static_name, uint32_t interval,
+                                  std::function<void()> &&func) {
   const uint32_t now = this->millis_();
 
-  if (!name.empty())
-    this->cancel_interval(component, name);
+  this->cancel_item_(component, name, SchedulerItem::INTERVAL);
 
   if (interval == SCHEDULER_DONT_RUN)
     return;
@@ -53,11 +69,9 @@ void HOT Scheduler::set_interval(Component *component, const std::string &name,
   if (interval != 0)
     offset = (random_uint32() % interval) / 2;
 
-  ESP_LOGVV(TAG, "set_interval(name='%s', interval=%u, offset=%u)", name.c_str(), interval, offset);
+  ESP_LOGVV(TAG, "set_interval(name='%s', interval=%u, offset=%u)", name, interval, offset);
 
-  auto item = make_unique<SchedulerItem>();
-  item->component = component;
-  item->name = name;
+  auto item = this->make_item_(component, name, static_name);
   item->type = SchedulerItem::INTERVAL;
   item->interval = interval;
   item->last_execution = now - offset - interval;
@@ -65,10 +79,13 @@ void HOT Scheduler::set_interval(Component *component, const std::string &name,
   if (item->last_execution > now)
     item->last_execution_major--;
   item->f = std::move(func);
-  item->remove = false;
+  this->index_item_(item.get());
   this->push_(std::move(item));
 }
 bool HOT Scheduler::cancel_interval(Component *component, const std::string &name) {
+  return this->cancel_item_(component, name.c_str(), SchedulerItem::INTERVAL);
+}
+bool HOT Scheduler::cancel_interval(Component *component, const char *name) {
   return this->cancel_item_(component, name, SchedulerItem::INTERVAL);
 }
 optional<uint32_t> HOT Scheduler::next_schedule_in() {
@@ -93,13 +110,12 @@ void ICACHE_RAM_ATTR HOT Scheduler::call() {
     std::vector<std::unique_ptr<SchedulerItem>> old_items;
     ESP_LOGVV(TAG, "Items: count=%u, now=%u", this->items_.size(), now);
     while (!this->empty_()) {
-      auto item = std::move(this->items_[0]);
+      auto item = this->pop_raw_();
       const char *type = item->type == SchedulerItem::INTERVAL ? "interval" : "timeout";
-      ESP_LOGVV(TAG, "  %s '%s' interval=%u last_execution=%u (%u) next=%u (%u)", type, item->name.c_str(),
+      ESP_LOGVV(TAG, "  %s '%s' interval=%u last_execution=%u (%u) next=%u (%u)", type, item->get_name(),
                 item->interval, item->last_execution, item->last_execution_major, item->next_execution(),
                 item->next_execution_major());
 
-      this->pop_raw_();
       old_items.push_back(std::move(item));
     }
     ESP_LOGVV(TAG, "\n");
@@ -121,32 +137,41 @@ void ICACHE_RAM_ATTR HOT Scheduler::call() {
 
       // Don't run on failed components
       if (item->component != nullptr && item->component->is_failed()) {
-        this->pop_raw_();
+        auto failed = this->pop_raw_();
+        this->unindex_item_(failed.get());
+        this->free_item_(std::move(failed));
         continue;
       }
 
 #ifdef ESPHOME_LOG_HAS_VERY_VERBOSE
       const char *type = item->type == SchedulerItem::INTERVAL ? "interval" : "timeout";
-      ESP_LOGVV(TAG, "Running %s '%s' with interval=%u last_execution=%u (now=%u)", type, item->name.c_str(),
+      ESP_LOGVV(TAG, "Running %s '%s' with interval=%u last_execution=%u (now=%u)", type, item->get_name(),
                 item->interval, item->last_execution, now);
 #endif
 
       // Warning: During f(), a lot of stuff can happen, including:
       //  - timeouts/intervals get added, potentially invalidating vector pointers
       //  - timeouts/intervals get cancelled
+#ifdef USE_PROFILER
+      Component *component = item->component;
+      const uint32_t start = micros();
+      item->f();
+      if (component != nullptr)
+        component->get_scheduler_stats().record(micros() - start);
+#else
       item->f();
+#endif
     }
 
     {
       // new scope, item from before might have been moved in the vector
-      auto item = std::move(this->items_[0]);
-
       // Only pop after function call, this ensures we were reachable
       // during the function call and know if we were cancelled.
-      this->pop_raw_();
+      auto item = this->pop_raw_();
 
       if (item->remove) {
         // We were removed/cancelled in the function call, stop
+        this->free_item_(std::move(item));
         continue;
       }
 
@@ -159,6 +184,9 @@ void ICACHE_RAM_ATTR HOT Scheduler::call() {
             item->last_execution_major++;
         }
         this->push_(std::move(item));
+      } else {
+        this->unindex_item_(item.get());
+        this->free_item_(std::move(item));
       }
     }
   }
@@ -168,6 +196,7 @@ void ICACHE_RAM_ATTR HOT Scheduler::call() {
 void HOT Scheduler::process_to_add() {
   for (auto &it : this->to_add_) {
     if (it->remove) {
+      this->free_item_(std::move(it));
       continue;
     }
 
@@ -178,33 +207,96 @@ void HOT Scheduler::process_to_add() {
 }
 void HOT Scheduler::cleanup_() {
   while (!this->items_.empty()) {
-    auto &item = this->items_[0];
-    if (!item->remove)
+    if (!this->items_[0]->remove)
       return;
 
-    this->pop_raw_();
+    this->free_item_(this->pop_raw_());
   }
 }
-void HOT Scheduler::pop_raw_() {
+std::unique_ptr<Scheduler::SchedulerItem> HOT Scheduler::pop_raw_() {
   std::pop_heap(this->items_.begin(), this->items_.end(), SchedulerItem::cmp);
+  auto item = std::move(this->items_.back());
   this->items_.pop_back();
+  return item;
 }
 void HOT Scheduler::push_(std::unique_ptr<Scheduler::SchedulerItem> item) { this->to_add_.push_back(std::move(item)); }
-bool HOT Scheduler::cancel_item_(Component *component, const std::string &name, Scheduler::SchedulerItem::Type type) {
+std::unique_ptr<Scheduler::SchedulerItem> Scheduler::make_item_(Component *component, const char *name,
+                                                                 bool static_name) {
+  std::unique_ptr<SchedulerItem> item;
+  if (this->free_items_.empty()) {
+    item = make_unique<SchedulerItem>();
+  } else {
+    item = std::move(this->free_items_.back());
+    this->free_items_.pop_back();
+  }
+  item->component = component;
+  if (static_name) {
+    item->static_name = name;
+  } else {
+    item->static_name = nullptr;
+    item->dynamic_name = name;
+  }
+  item->remove = false;
+  item->next_named = nullptr;
+  return item;
+}
+void HOT Scheduler::free_item_(std::unique_ptr<SchedulerItem> item) {
+  if (this->free_items_.size() >= SCHEDULER_MAX_FREE_ITEMS)
+    return;
+  // release everything captured by the callback now, not when the item is reused
+  item->f = nullptr;
+  // clear() keeps the capacity, so short dynamic names don't need to allocate again either
+  item->dynamic_name.clear();
+  this->free_items_.push_back(std::move(item));
+}
+bool HOT Scheduler::cancel_item_(Component *component, const char *name, Scheduler::SchedulerItem::Type type) {
+  if (name == nullptr || name[0] == '\0')
+    return false;
+
+  // Cancelled items are only marked here, they're removed from the heap once they reach the top.
   bool ret = false;
-  for (auto &it : this->items_)
-    if (it->component == component && it->name == name && it->type == type) {
-      it->remove = true;
-      ret = true;
-    }
-  for (auto &it : this->to_add_)
-    if (it->component == component && it->name == name && it->type == type) {
-      it->remove = true;
+  const uint32_t key = item_key_(component, name, type);
+  SchedulerItem **link = &this->named_bucket_(key);
+  while (*link != nullptr) {
+    SchedulerItem *item = *link;
+    if (item->key == key && item->component == component && item->type == type &&
+        strcmp(item->get_name(), name) == 0) {
+      item->remove = true;
       ret = true;
+      *link = item->next_named;
+      item->next_named = nullptr;
+    } else {
+      link = &item->next_named;
     }
+  }
 
   return ret;
 }
+uint32_t Scheduler::item_key_(Component *component, const char *name, SchedulerItem::Type type) {
+  uint32_t key = fnv1_hash(name);
+  key ^= reinterpret_cast<uintptr_t>(component) * 16777619UL;
+  key ^= static_cast<uint32_t>(type);
+  return key;
+}
+void HOT Scheduler::index_item_(SchedulerItem *item) {
+  if (!item->has_name())
+    return;
+  item->key = item_key_(item->component, item->get_name(), item->type);
+  SchedulerItem *&bucket = this->named_bucket_(item->key);
+  item->next_named = bucket;
+  bucket = item;
+}
+void HOT Scheduler::unindex_item_(SchedulerItem *item) {
+  if (!item->has_name())
+    return;
+  for (SchedulerItem **link = &this->named_bucket_(item->key); *link != nullptr; link = &(*link)->next_named) {
+    if (*link == item) {
+      *link = item->next_named;
+      item->next_named = nullptr;
+      return;
+    }
+  }
+}
 uint32_t Scheduler::millis_() {
   const uint32_t now = millis();
   if (now < this->last_millis_) {
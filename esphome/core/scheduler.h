@@ -11,9 +11,21 @@ class Component;
 class Scheduler {
  public:
   void set_timeout(Component *component, const std::string &name, uint32_t timeout, std::function<void()> &&func);
+  /** Set a timeout with a static name (like a string literal), the name is not copied.
+   *
+   * The name must stay valid as long as the timeout is scheduled.
+   */
+  void set_timeout(Component *component, const char *name, uint32_t timeout, std::function<void()> &&func);
   bool cancel_timeout(Component *component, const std::string &name);
+  bool cancel_timeout(Component *component, const char *name);
   void set_interval(Component *component, const std::string &name, uint32_t interval, std::function<void()> &&func);
+  /** Set an interval with a static name (like a string literal), the name is not copied.
+   *
+   * The name must stay valid as long as the interval is scheduled.
+   */
+  void set_interval(Component *component, const char *name, uint32_t interval, std::function<void()> &&func);
   bool cancel_interval(Component *component, const std::string &name);
+  bool cancel_interval(Component *component, const char *name);
 
   optional<uint32_t> next_schedule_in();
 
@@ -24,7 +36,9 @@ class Scheduler {
  protected:
   struct SchedulerItem {
     Component *component;
-    std::string name;
+    /// Name with static storage, or nullptr if the name is stored in dynamic_name.
+    const char *static_name;
+    std::string dynamic_name;
     enum Type { TIMEOUT, INTERVAL } type;
     union {
       uint32_t interval;
@@ -34,6 +48,15 @@ class Scheduler {
     std::function<void()> f;
     bool remove;
     uint8_t last_execution_major;
+    /// Hash of component, name and type, only used for named items.
+    uint32_t key;
+    /// Next item in the same named_items_ bucket.
+    SchedulerItem *next_named;
+
+    const char *get_name() const {
+      return this->static_name != nullptr ? this->static_name : this->dynamic_name.c_str();
+    }
+    bool has_name() const { return this->get_name()[0] != '\0'; }
 
     inline uint32_t next_execution() { return this->last_execution + this->timeout; }
     inline uint8_t next_execution_major() {
@@ -49,9 +72,24 @@ class Scheduler {
 
   uint32_t millis_();
   void cleanup_();
-  void pop_raw_();
+  /// Remove the first item from the heap and return it.
+  std::unique_ptr<SchedulerItem> pop_raw_();
   void push_(std::unique_ptr<SchedulerItem> item);
-  bool cancel_item_(Component *component, const std::string &name, SchedulerItem::Type type);
+  void set_timeout_(Component *component, const char *name, bool static_name, uint32_t timeout,
+                    std::function<void()> &&func);
+  void set_interval_(Component *component, const char *name, bool static_name, uint32_t interval,
+                     std::function<void()> &&func);
+  /// Create an item with the given name, reusing a previously freed one if possible.
+  std::unique_ptr<SchedulerItem> make_item_(Component *component, const char *name, bool static_name);
+  /// Keep a finished item around for reuse by make_item_().
+  void free_item_(std::unique_ptr<SchedulerItem> item);
+  bool cancel_item_(Component *component, const char *name, SchedulerItem::Type type);
+  static uint32_t item_key_(Component *component, const char *name, SchedulerItem::Type type);
+  SchedulerItem *&named_bucket_(uint32_t key) { return this->named_items_[key % NAMED_ITEM_BUCKETS]; }
+  /// Add a named item to named_items_.
+  void index_item_(SchedulerItem *item);
+  /// Remove the item from named_items_ when it's destroyed without being cancelled.
+  void unindex_item_(SchedulerItem *item);
   bool empty_() {
     this->cleanup_();
     return this->items_.empty();
@@ -59,6 +97,14 @@ class Scheduler {
 
   std::vector<std::unique_ptr<SchedulerItem>> items_;
   std::vector<std::unique_ptr<SchedulerItem>> to_add_;
+  static const size_t NAMED_ITEM_BUCKETS = 32;
+  /** Named items that haven't been cancelled, hashed by key into buckets of singly linked lists (through
+   * SchedulerItem::next_named). Used to find items to cancel without scanning the heap, and without
+   * allocating or moving other entries on insert/erase.
+   */
+  SchedulerItem *named_items_[NAMED_ITEM_BUCKETS]{};
+  /// Finished items kept for reuse, so scheduling doesn't need to allocate.
+  std::vector<std::unique_ptr<SchedulerItem>> free_items_;
   uint32_t last_millis_{0};
   uint8_t millis_major_{0};
 };
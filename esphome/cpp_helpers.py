@@ -1,5 +1,5 @@
 from esphome.const import CONF_INVERTED, CONF_MODE, CONF_NUMBER, CONF_SETUP_PRIORITY, \
-    CONF_UPDATE_INTERVAL, CONF_TYPE_ID
+    CONF_UPDATE_INTERVAL, CONF_TYPE_ID, CONF_DEBUG, CONF_PROFILER
 # pylint: disable=unused-import
 from esphome.core import coroutine, ID, CORE, ConfigType
 from esphome.cpp_generator import RawExpression, add, get_variable
@@ -46,6 +46,8 @@ def register_component(var, config):
         add(var.set_setup_priority(config[CONF_SETUP_PRIORITY]))
     if CONF_UPDATE_INTERVAL in config:
         add(var.set_update_interval(config[CONF_UPDATE_INTERVAL]))
+    if CORE.config is not None and CONF_PROFILER in CORE.config.get(CONF_DEBUG, {}):
+        add(var.set_component_source(id_))
     add(App.register_component(var))
     yield var
 
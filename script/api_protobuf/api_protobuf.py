@@ -163,6 +163,12 @@ class TypeInfo():
 
     encode_func = None
 
+    @property
+    def size_content(self):
+        return f'ProtoSize::{self.size_func}(total_size, {self.number}, this->{self.field_name});'
+
+    size_func = None
+
     @property
     def dump_content(self):
         o = f'out.append("  {self.name}: ");\n'
@@ -190,6 +196,7 @@ class DoubleType(TypeInfo):
     default_value = '0.0'
     decode_64bit = 'value.as_double()'
     encode_func = 'encode_double'
+    size_func = 'add_double_field'
 
     def dump(self, name):
         o = f'sprintf(buffer, "%g", {name});\n'
@@ -203,6 +210,7 @@ class FloatType(TypeInfo):
     default_value = '0.0f'
     decode_32bit = 'value.as_float()'
     encode_func = 'encode_float'
+    size_func = 'add_float_field'
 
     def dump(self, name):
         o = f'sprintf(buffer, "%g", {name});\n'
@@ -216,9 +224,10 @@ class Int64Type(TypeInfo):
     default_value = '0'
     decode_varint = 'value.as_int64()'
     encode_func = 'encode_int64'
+    size_func = 'add_int64_field'
 
     def dump(self, name):
-        o = f'sprintf(buffer, "%ll", {name});\n'
+        o = f'sprintf(buffer, "%lld", {name});\n'
         o += f'out.append(buffer);'
         return o
 
@@ -229,9 +238,10 @@ class UInt64Type(TypeInfo):
     default_value = '0'
     decode_varint = 'value.as_uint64()'
     encode_func = 'encode_uint64'
+    size_func = 'add_uint64_field'
 
     def dump(self, name):
-        o = f'sprintf(buffer, "%ull", {name});\n'
+        o = f'sprintf(buffer, "%llu", {name});\n'
         o += f'out.append(buffer);'
         return o
 
@@ -242,6 +252,7 @@ class Int32Type(TypeInfo):
     default_value = '0'
     decode_varint = 'value.as_int32()'
     encode_func = 'encode_int32'
+    size_func = 'add_int32_field'
 
     def dump(self, name):
         o = f'sprintf(buffer, "%d", {name});\n'
@@ -255,9 +266,10 @@ class Fixed64Type(TypeInfo):
     default_value = '0'
     decode_64bit = 'value.as_fixed64()'
     encode_func = 'encode_fixed64'
+    size_func = 'add_fixed64_field'
 
     def dump(self, name):
-        o = f'sprintf(buffer, "%ull", {name});\n'
+        o = f'sprintf(buffer, "%llu", {name});\n'
         o += f'out.append(buffer);'
         return o
 
@@ -268,6 +280,7 @@ class Fixed32Type(TypeInfo):
     default_value = '0'
     decode_32bit = 'value.as_fixed32()'
     encode_func = 'encode_fixed32'
+    size_func = 'add_fixed32_field'
 
     def dump(self, name):
         o = f'sprintf(buffer, "%u", {name});\n'
@@ -281,6 +294,7 @@ class BoolType(TypeInfo):
     default_value = 'false'
     decode_varint = 'value.as_bool()'
     encode_func = 'encode_bool'
+    size_func = 'add_bool_field'
 
     def dump(self, name):
         o = f'out.append(YESNO({name}));'
@@ -295,6 +309,7 @@ class StringType(TypeInfo):
     const_reference_type = 'const std::string &'
     decode_length = 'value.as_string()'
     encode_func = 'encode_string'
+    size_func = 'add_string_field'
 
     def dump(self, name):
         o = f'out.append("\'").append({name}).append("\'");'
@@ -321,6 +336,10 @@ class MessageType(TypeInfo):
     def encode_func(self):
         return f'encode_message<{self.cpp_type}>'
 
+    @property
+    def size_func(self):
+        return f'add_message_field<{self.cpp_type}>'
+
     @property
     def decode_length(self):
         return f'value.as_message<{self.cpp_type}>()'
@@ -338,6 +357,7 @@ class BytesType(TypeInfo):
     const_reference_type = 'const std::string &'
     decode_length = 'value.as_string()'
     encode_func = 'encode_string'
+    size_func = 'add_string_field'
 
     def dump(self, name):
         o = f'out.append("\'").append({name}).append("\'");'
@@ -350,6 +370,7 @@ class UInt32Type(TypeInfo):
     default_value = '0'
     decode_varint = 'value.as_uint32()'
     encode_func = 'encode_uint32'
+    size_func = 'add_uint32_field'
 
     def dump(self, name):
         o = f'sprintf(buffer, "%u", {name});\n'
@@ -373,6 +394,10 @@ class EnumType(TypeInfo):
     def encode_func(self):
         return f'encode_enum<{self.cpp_type}>'
 
+    @property
+    def size_func(self):
+        return f'add_enum_field<{self.cpp_type}>'
+
     def dump(self, name):
         o = f'out.append(proto_enum_to_string<{self.cpp_type}>({name}));'
         return o
@@ -384,6 +409,7 @@ class SFixed32Type(TypeInfo):
     default_value = '0'
     decode_32bit = 'value.as_sfixed32()'
     encode_func = 'encode_sfixed32'
+    size_func = 'add_sfixed32_field'
 
     def dump(self, name):
         o = f'sprintf(buffer, "%d", {name});\n'
@@ -397,9 +423,10 @@ class SFixed64Type(TypeInfo):
     default_value = '0'
     decode_64bit = 'value.as_sfixed64()'
     encode_func = 'encode_sfixed64'
+    size_func = 'add_sfixed64_field'
 
     def dump(self, name):
-        o = f'sprintf(buffer, "%ll", {name});\n'
+        o = f'sprintf(buffer, "%lld", {name});\n'
         o += f'out.append(buffer);'
         return o
 
@@ -410,6 +437,7 @@ class SInt32Type(TypeInfo):
     default_value = '0'
     decode_varint = 'value.as_sint32()'
     encode_func = 'encode_sint32'
+    size_func = 'add_sint32_field'
 
     def dump(self, name):
         o = f'sprintf(buffer, "%d", {name});\n'
@@ -422,10 +450,11 @@ class SInt64Type(TypeInfo):
     cpp_type = 'int64_t'
     default_value = '0'
     decode_varint = 'value.as_sint64()'
-    encode_func = 'encode_sin64'
+    encode_func = 'encode_sint64'
+    size_func = 'add_sint64_field'
 
     def dump(self):
-        o = f'sprintf(buffer, "%ll", {name});\n'
+        o = f'sprintf(buffer, "%lld", {name});\n'
         o += f'out.append(buffer);'
         return o
 
@@ -503,6 +532,13 @@ class RepeatedTypeInfo(TypeInfo):
           buffer.{self._ti.encode_func}({self.number}, it, true);
         }}"""
 
+    @property
+    def size_content(self):
+        return f"""\
+        for (auto {'' if self._ti_is_bool else '&'}it : this->{self.field_name}) {{
+          ProtoSize::{self._ti.size_func}(total_size, {self.number}, it, true);
+        }}"""
+
     @property
     def dump_content(self):
         o = f'for (const auto {"" if self._ti_is_bool else "&"}it : this->{self.field_name}) {{\n'
@@ -540,6 +576,7 @@ def build_message_type(desc):
     decode_32bit = []
     decode_64bit = []
     encode = []
+    size = []
     dump = []
 
     for field in desc.field:
@@ -550,6 +587,7 @@ def build_message_type(desc):
         protected_content.extend(ti.protected_content)
         public_content.extend(ti.public_content)
         encode.append(ti.encode_content)
+        size.append(ti.size_content)
 
         if ti.decode_varint_content:
             decode_varint.append(ti.decode_varint_content)
@@ -611,6 +649,13 @@ def build_message_type(desc):
     prot = 'void encode(ProtoWriteBuffer buffer) const override;'
     public_content.append(prot)
 
+    o = f"void {desc.name}::calculate_size(uint32_t &total_size) const {{\n"
+    o += indent('\n'.join(size)) + '\n'
+    o += '}\n'
+    cpp += o
+    prot = 'void calculate_size(uint32_t &total_size) const override;'
+    public_content.append(prot)
+
     o = f"void {desc.name}::dump_to(std::string &out) const {{\n"
     if dump:
         o += f"  char buffer[64];\n"
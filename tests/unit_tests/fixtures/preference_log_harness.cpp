@@ -0,0 +1,413 @@
+// Crash-consistency and benchmark harness for esphome/core/preference_log.cpp, built for the host by
+// test_preference_log.py. Every scenario exits with 0 and prints "OK" if all checks passed.
+#include <algorithm>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "esphome/core/preference_log.h"
+
+namespace esphome {
+
+void esp_log_printf_(int level, const char *tag, int line, const char *format, ...) {  // NOLINT
+  va_list args;
+  va_start(args, format);
+  fprintf(stderr, "[%d][%s:%d]: ", level, tag, line);
+  vfprintf(stderr, format, args);
+  fprintf(stderr, "\n");
+  va_end(args);
+}
+
+}  // namespace esphome
+
+using namespace esphome;
+
+static int failures = 0;
+
+#define CHECK(cond, ...) \
+  do { \
+    if (!(cond)) { \
+      failures++; \
+      printf("FAIL %s:%d: %s: ", __FILE__, __LINE__, #cond); \
+      printf(__VA_ARGS__); \
+      printf("\n"); \
+    } \
+  } while (false)
+
+/// Loses power after a given number of written words: the write that crosses the limit is torn, later
+/// writes and erases have no effect.
+class FaultInjectingStorage : public PreferenceLogStorage {
+ public:
+  explicit FaultInjectingStorage(PreferenceLogStorage *storage) : storage_(storage) {}
+  void lose_power_after(int64_t words) { this->budget_ = words; }
+
+  uint32_t size_words() const override { return this->storage_->size_words(); }
+  bool read(uint32_t position, uint32_t *dest, size_t length_words) override {
+    return !this->powered_off_ && this->storage_->read(position, dest, length_words);
+  }
+  bool write(uint32_t position, const uint32_t *src, size_t length_words) override {
+    if (this->powered_off_)
+      return false;
+    if (this->budget_ < 0)
+      return this->storage_->write(position, src, length_words);
+    size_t written = std::min<int64_t>(this->budget_, length_words);
+    if (written != 0)
+      this->storage_->write(position, src, written);
+    this->budget_ -= written;
+    this->powered_off_ = written != length_words;
+    return !this->powered_off_;
+  }
+  bool erase() override { return !this->powered_off_ && this->storage_->erase(); }
+
+ protected:
+  PreferenceLogStorage *storage_;
+  int64_t budget_{-1};
+  bool powered_off_{false};
+};
+
+/// Overwrite a word of the log file behind the storage's back, like a bit flip in flash would.
+static void corrupt(const std::string &path, uint32_t position, uint32_t xor_mask) {
+  FILE *file = fopen(path.c_str(), "r+b");
+  uint32_t word;
+  fseek(file, position * 4, SEEK_SET);
+  CHECK(fread(&word, 4, 1, file) == 1, "reading word %u", position);
+  word ^= xor_mask;
+  fseek(file, position * 4, SEEK_SET);
+  fwrite(&word, 4, 1, file);
+  fclose(file);
+}
+
+/// The in-memory model of a set of preferences, what a device holds in its flash_storage_ image.
+struct Model {
+  struct Pref {
+    uint32_t type;
+    uint16_t instance;
+    std::vector<uint32_t> data;
+  };
+  std::vector<Pref> prefs;
+
+  Model(size_t count, uint16_t length_words) {
+    for (size_t i = 0; i < count; i++) {
+      // A few preferences share a type, like several components of the same kind do
+      Pref pref{uint32_t(0x1000 + i / 3), uint16_t(i % 3), std::vector<uint32_t>(length_words)};
+      this->prefs.push_back(pref);
+    }
+    this->update_all(0);
+  }
+  static uint32_t value(size_t index, uint32_t generation, size_t word) {
+    return uint32_t(index * 7919 + generation * 104729 + word * 31 + 1);
+  }
+  void update(size_t index, uint32_t generation) {
+    for (size_t w = 0; w < this->prefs[index].data.size(); w++)
+      this->prefs[index].data[w] = value(index, generation, w);
+  }
+  void update_all(uint32_t generation) {
+    for (size_t i = 0; i < this->prefs.size(); i++)
+      this->update(i, generation);
+  }
+  PreferenceLog::Record record(size_t index) const {
+    auto &pref = this->prefs[index];
+    return PreferenceLog::Record{pref.type, pref.instance, uint16_t(pref.data.size()), pref.data.data()};
+  }
+  std::vector<PreferenceLog::Record> records(const std::vector<size_t> &indices) const {
+    std::vector<PreferenceLog::Record> result;
+    for (size_t index : indices)
+      result.push_back(this->record(index));
+    return result;
+  }
+  std::vector<size_t> all() const {
+    std::vector<size_t> result;
+    for (size_t i = 0; i < this->prefs.size(); i++)
+      result.push_back(i);
+    return result;
+  }
+};
+
+/// Restore every preference like ESPPreferences::make_preference() does, returns the generation of each one
+/// (-1 if missing). Data that matches no known generation is reported as a failure.
+static std::vector<int> restore(PreferenceLog &log, const Model &model, uint32_t max_generation) {
+  std::vector<int> generations;
+  for (size_t i = 0; i < model.prefs.size(); i++) {
+    auto &pref = model.prefs[i];
+    const PreferenceLog::IndexEntry *entry = log.find(pref.type, pref.instance);
+    if (entry == nullptr || entry->length_words != pref.data.size()) {
+      generations.push_back(-1);
+      continue;
+    }
+    std::vector<uint32_t> data(entry->length_words);
+    CHECK(log.read_data(*entry, data.data()), "reading preference %zu", i);
+    int generation = -1;
+    for (uint32_t g = 0; g <= max_generation && generation == -1; g++) {
+      bool match = true;
+      for (size_t w = 0; w < data.size(); w++)
+        match = match && data[w] == Model::value(i, g, w);
+      if (match)
+        generation = g;
+    }
+    CHECK(generation != -1, "preference %zu restored data that was never saved", i);
+    generations.push_back(generation);
+  }
+  return generations;
+}
+
+/// A fresh log file holding generation 0 of every preference.
+static void prepare(const std::string &path, uint32_t size_words, const Model &model) {
+  remove(path.c_str());
+  MmapPreferenceLogStorage storage(path, size_words);
+  CHECK(storage.open(), "opening %s", path.c_str());
+  PreferenceLog log(&storage, 256);
+  CHECK(log.compact(model.records(model.all())), "initial compaction");
+}
+
+/// Power is lost at every word of an append that updates half the preferences. Each preference has to come
+/// back with its old or new value, records written completely before the power loss with the new one. The
+/// log has to accept new records afterwards.
+static void scenario_torn_write(const std::string &path) {
+  const uint32_t size_words = 1024;
+  Model model(12, 4);
+  std::vector<size_t> updated;
+  for (size_t i = 0; i < model.prefs.size(); i += 2)
+    updated.push_back(i);
+  const int64_t append_words = updated.size() * (4 + PreferenceLog::RECORD_OVERHEAD);
+
+  for (int64_t cut = 0; cut <= append_words; cut++) {
+    model.update_all(0);
+    prepare(path, size_words, model);
+    for (size_t index : updated)
+      model.update(index, 1);
+    {
+      MmapPreferenceLogStorage storage(path, size_words);
+      storage.open();
+      FaultInjectingStorage faulty(&storage);
+      PreferenceLog log(&faulty, 256);
+      CHECK(log.load(), "loading before the power loss");
+      faulty.lose_power_after(cut);
+      bool success = log.append(model.records(updated));
+      CHECK(success == (cut == append_words), "append result with power loss after %lld words", (long long) cut);
+    }
+
+    MmapPreferenceLogStorage storage(path, size_words);
+    storage.open();
+    PreferenceLog log(&storage, 256);
+    log.load();
+    std::vector<int> generations = restore(log, model, 2);
+    const int64_t complete = cut / (4 + PreferenceLog::RECORD_OVERHEAD);
+    for (size_t i = 0; i < model.prefs.size(); i++) {
+      size_t position = std::find(updated.begin(), updated.end(), i) - updated.begin();
+      int expected = position < size_t(complete) ? 1 : 0;
+      CHECK(generations[i] == expected, "cut %lld: preference %zu has generation %d, expected %d", (long long) cut,
+            i, generations[i], expected);
+    }
+
+    // A device keeps saving after the reboot, either appending or compacting a damaged log
+    model.update(1, 2);
+    std::vector<size_t> next{1};
+    if (log.can_append(model.records(next))) {
+      CHECK(log.append(model.records(next)), "cut %lld: append after the power loss", (long long) cut);
+    } else {
+      for (size_t index : updated)
+        model.update(index, generations[index] == 1 ? 1 : 0);
+      CHECK(log.compact(model.records(model.all())), "cut %lld: compaction after the power loss", (long long) cut);
+    }
+    PreferenceLog reloaded(&storage, 256);
+    CHECK(reloaded.load(), "cut %lld: loading after the next save", (long long) cut);
+    CHECK(restore(reloaded, model, 2)[1] == 2, "cut %lld: the next save was lost", (long long) cut);
+  }
+}
+
+/// Flip a bit in the data and in the checksum of the newest record, and damage a record header.
+static void scenario_crc_mismatch(const std::string &path) {
+  const uint32_t size_words = 1024;
+  Model model(6, 4);
+  const uint32_t record_words = 4 + PreferenceLog::RECORD_OVERHEAD;
+  const uint32_t corrupt_words[] = {
+      2,                 // data
+      record_words - 1,  // checksum
+  };
+  for (uint32_t offset : corrupt_words) {
+    model.update_all(0);
+    prepare(path, size_words, model);
+    MmapPreferenceLogStorage storage(path, size_words);
+    storage.open();
+    PreferenceLog log(&storage, 256);
+    CHECK(log.load(), "loading the fresh log");
+    model.update(3, 1);
+    CHECK(log.append(model.records({3})), "appending generation 1");
+    model.update(4, 1);
+    const uint32_t position = log.get_write_position();
+    CHECK(log.append(model.records({4})), "appending generation 1");
+
+    corrupt(path, position + offset, 1 << 5);
+
+    PreferenceLog reloaded(&storage, 256);
+    CHECK(reloaded.load(), "a bad checksum must not stop the scan");
+    std::vector<int> generations = restore(reloaded, model, 1);
+    CHECK(generations[3] == 1, "the record before the damaged one was lost");
+    CHECK(generations[4] == 0, "word %u: expected the previous record of the damaged preference, got %d", offset,
+          generations[4]);
+    CHECK(reloaded.get_write_position() == position + record_words, "appending has to continue after the record");
+  }
+
+  // A damaged length can't be skipped: the scan stops, keeps what it found and the next save compacts
+  model.update_all(0);
+  prepare(path, size_words, model);
+  MmapPreferenceLogStorage storage(path, size_words);
+  storage.open();
+  PreferenceLog log(&storage, 256);
+  log.load();
+  model.update(2, 1);
+  const uint32_t position = log.get_write_position();
+  log.append(model.records({2}));
+  model.update(5, 1);
+  log.append(model.records({5}));
+  corrupt(path, position + 1, 0x0000FF00);  // a length far beyond the longest record
+
+  PreferenceLog reloaded(&storage, 256);
+  CHECK(!reloaded.load(), "a damaged header has to be reported");
+  std::vector<int> generations = restore(reloaded, model, 1);
+  CHECK(generations[0] == 0 && generations[1] == 0, "records before the damaged header were lost");
+  CHECK(generations[2] == 0 && generations[5] == 0, "expected the records before the damaged header");
+  CHECK(!reloaded.can_append(model.records({5})), "appending to a damaged log");
+  CHECK(reloaded.compact(model.records(model.all())), "compacting the damaged log");
+  PreferenceLog compacted(&storage, 256);
+  CHECK(compacted.load(), "loading the compacted log");
+  generations = restore(compacted, model, 1);
+  CHECK(generations[2] == 1 && generations[5] == 1, "compaction lost the latest values");
+}
+
+/// Power is lost at every word of a compaction. With a single sector, the preferences that weren't written
+/// again are gone, but nothing may come back with data that wasn't saved.
+static void scenario_compaction_power_loss(const std::string &path) {
+  const uint32_t size_words = 128;
+  Model model(8, 4);
+  const uint32_t record_words = 4 + PreferenceLog::RECORD_OVERHEAD;
+  const int64_t compaction_words = 1 + model.prefs.size() * record_words;
+
+  for (int64_t cut = 0; cut <= compaction_words; cut++) {
+    model.update_all(0);
+    prepare(path, size_words, model);
+    uint32_t saves = 0;
+    {
+      MmapPreferenceLogStorage storage(path, size_words);
+      storage.open();
+      FaultInjectingStorage faulty(&storage);
+      PreferenceLog log(&faulty, 256);
+      log.load();
+      // Keep saving until the next save needs a compaction
+      while (true) {
+        const size_t index = saves % model.prefs.size();
+        model.update(index, saves / model.prefs.size() + 1);
+        saves++;
+        if (!log.can_append(model.records({index})))
+          break;
+        CHECK(log.append(model.records({index})), "filling the log");
+      }
+      // The erase still succeeds, power is lost after cut words of the rewrite
+      faulty.lose_power_after(cut);
+      bool success = log.compact(model.records(model.all()));
+      CHECK(success == (cut == compaction_words), "compaction result with power loss after %lld words",
+            (long long) cut);
+    }
+
+    MmapPreferenceLogStorage storage(path, size_words);
+    storage.open();
+    PreferenceLog log(&storage, 256);
+    if (!log.has_magic()) {
+      CHECK(cut == 0, "cut %lld: the magic is written first and has to survive", (long long) cut);
+      continue;
+    }
+    // Fails if the power loss tore a record header, the records before it are restored anyway
+    log.load();
+    std::vector<int> generations = restore(log, model, saves / model.prefs.size() + 1);
+    const int64_t complete = (cut - 1) / record_words;
+    for (size_t i = 0; i < model.prefs.size(); i++) {
+      if (int64_t(i) < complete) {
+        CHECK(generations[i] != -1, "cut %lld: preference %zu was written completely but is lost", (long long) cut,
+              i);
+      } else {
+        CHECK(generations[i] == -1, "cut %lld: preference %zu wasn't written yet but is restored", (long long) cut,
+              i);
+      }
+    }
+  }
+}
+
+/// Save and restore throughput, and the restore cost at boot for a config with many preferences.
+static void scenario_benchmark(const std::string &path, size_t count, size_t saves) {
+  using clock = std::chrono::steady_clock;
+  const uint32_t size_words = 65535;
+  Model model(count, 4);
+  prepare(path, size_words, model);
+
+  MmapPreferenceLogStorage storage(path, size_words);
+  storage.open();
+  PreferenceLog log(&storage, 256);
+  log.load();
+  size_t compactions = 0;
+  auto start = clock::now();
+  for (size_t i = 0; i < saves; i++) {
+    model.update(i % count, i / count + 1);
+    auto records = model.records({i % count});
+    if (log.can_append(records)) {
+      CHECK(log.append(records), "save %zu", i);
+    } else {
+      CHECK(log.compact(model.records(model.all())), "compaction at save %zu", i);
+      compactions++;
+    }
+  }
+  double save_s = std::chrono::duration<double>(clock::now() - start).count();
+
+  start = clock::now();
+  MmapPreferenceLogStorage restored_storage(path, size_words);
+  restored_storage.open();
+  PreferenceLog restored(&restored_storage, 256);
+  CHECK(restored.load(), "loading for the restore");
+  double load_s = std::chrono::duration<double>(clock::now() - start).count();
+  std::vector<uint32_t> data(4);
+  start = clock::now();
+  for (auto &pref : model.prefs) {
+    const PreferenceLog::IndexEntry *entry = restored.find(pref.type, pref.instance);
+    CHECK(entry != nullptr && restored.read_data(*entry, data.data()) && data == pref.data, "restoring");
+  }
+  double restore_s = std::chrono::duration<double>(clock::now() - start).count();
+
+  printf("preferences %zu\n", count);
+  printf("saves %zu\n", saves);
+  printf("compactions %zu\n", compactions);
+  printf("save_per_second %.0f\n", saves / save_s);
+  printf("save_words_per_second %.0f\n", saves * (4 + PreferenceLog::RECORD_OVERHEAD) / save_s);
+  printf("load_us %.1f\n", load_s * 1e6);
+  printf("restore_us %.1f\n", restore_s * 1e6);
+  printf("restore_us_per_preference %.3f\n", restore_s * 1e6 / count);
+}
+
+int main(int argc, char **argv) {
+  if (argc < 3) {
+    fprintf(stderr, "Usage: %s <torn-write|crc-mismatch|compaction-power-loss|benchmark> <file> [prefs] [saves]\n",
+            argv[0]);
+    return 2;
+  }
+  const std::string scenario = argv[1];
+  const std::string path = argv[2];
+  if (scenario == "torn-write") {
+    scenario_torn_write(path);
+  } else if (scenario == "crc-mismatch") {
+    scenario_crc_mismatch(path);
+  } else if (scenario == "compaction-power-loss") {
+    scenario_compaction_power_loss(path);
+  } else if (scenario == "benchmark") {
+    scenario_benchmark(path, argc > 3 ? atoi(argv[3]) : 500, argc > 4 ? atoi(argv[4]) : 20000);
+  } else {
+    fprintf(stderr, "Unknown scenario %s\n", scenario.c_str());
+    return 2;
+  }
+  if (failures != 0)
+    return 1;
+  printf("OK\n");
+  return 0;
+}
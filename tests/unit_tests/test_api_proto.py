@@ -0,0 +1,96 @@
+import shutil
+import subprocess
+from pathlib import Path
+
+import pytest
+
+package_root = Path(__file__).parent.parent.parent
+
+# Compiles the header-only varint code of the native API for the host. Arduino.h is only needed for
+# types and macros that the standard library provides as well.
+ARDUINO_STUB = """
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+"""
+
+ROUND_TRIP_PROGRAM = """
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include "esphome/components/api/proto.h"
+
+using namespace esphome::api;
+
+int main(int argc, char **argv) {
+  for (int i = 1; i < argc; i++) {
+    uint64_t value = strtoull(argv[i], nullptr, 10);
+    std::vector<uint8_t> out;
+    ProtoWriteBuffer buffer(&out);
+    buffer.encode_uint64(1, value, true);
+    uint32_t size = 0;
+    ProtoSize::add_uint64_field(size, 1, value, true);
+
+    uint8_t raw[10];
+    uint32_t raw_len = ProtoVarInt(value).encode_to_buffer_unchecked(raw);
+    uint32_t consumed;
+    auto parsed = ProtoVarInt::parse(raw, raw_len, &consumed);
+
+    printf("%u %u %" PRIu64 " ", size, consumed, parsed.has_value() ? parsed->as_uint64() : 0);
+    for (uint8_t byte : out)
+      printf("%02x", byte);
+    printf("\\n");
+  }
+  return 0;
+}
+"""
+
+
+def decode_varint(data):
+    value = 0
+    for i, byte in enumerate(data):
+        value |= (byte & 0x7F) << (7 * i)
+        if not byte & 0x80:
+            return value, i + 1
+    raise ValueError("Truncated varint")
+
+
+@pytest.fixture(scope="module")
+def round_trip_binary(tmp_path_factory):
+    compiler = shutil.which("g++")
+    if compiler is None:
+        pytest.skip("g++ is required to compile the native API varint code")
+    tmp_path = tmp_path_factory.mktemp("api_proto")
+    (tmp_path / "Arduino.h").write_text(ARDUINO_STUB)
+    source = tmp_path / "round_trip.cpp"
+    source.write_text(ROUND_TRIP_PROGRAM)
+    binary = tmp_path / "round_trip"
+    subprocess.run([compiler, "-std=gnu++11", "-I", str(package_root), "-I", str(tmp_path),
+                    str(source), "-o", str(binary)], check=True)
+    return binary
+
+
+@pytest.mark.parametrize("value", (
+        0,
+        0x7F,
+        0x80,
+        2**32 - 1,
+        2**32,
+        # About 71 minutes of profiler total_us
+        2**32 + 123456789,
+        2**63,
+        2**64 - 1,
+))
+def test_varint_round_trip(round_trip_binary, value):
+    output = subprocess.run([str(round_trip_binary), str(value)], check=True, stdout=subprocess.PIPE,
+                            universal_newlines=True).stdout
+    size, consumed, parsed, encoded = output.split()
+    encoded = bytes.fromhex(encoded)
+
+    assert encoded[0] == (1 << 3)
+    actual, length = decode_varint(encoded[1:])
+    assert actual == value
+    assert length + 1 == len(encoded)
+    assert int(size) == len(encoded)
+    assert int(consumed) == length
+    assert int(parsed) == value
@@ -0,0 +1,58 @@
+import shutil
+import subprocess
+from pathlib import Path
+
+import pytest
+
+package_root = Path(__file__).parent.parent.parent
+
+# preference_log.cpp only needs types and macros from Arduino.h that the standard library provides as well.
+ARDUINO_STUB = """
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+"""
+
+
+@pytest.fixture(scope="module")
+def harness_binary(tmp_path_factory):
+    compiler = shutil.which("g++")
+    if compiler is None:
+        pytest.skip("g++ is required to compile the preference log")
+    tmp_path = tmp_path_factory.mktemp("preference_log")
+    (tmp_path / "Arduino.h").write_text(ARDUINO_STUB)
+    binary = tmp_path / "harness"
+    subprocess.run([compiler, "-std=gnu++11", "-O2", "-I", str(package_root), "-I", str(tmp_path),
+                    str(package_root / "esphome" / "core" / "preference_log.cpp"),
+                    str(Path(__file__).parent / "fixtures" / "preference_log_harness.cpp"),
+                    "-o", str(binary)], check=True)
+    return binary
+
+
+def run_harness(binary, *args):
+    result = subprocess.run([str(binary)] + [str(arg) for arg in args], stdout=subprocess.PIPE,
+                            universal_newlines=True)
+    assert result.returncode == 0, result.stdout
+    lines = result.stdout.splitlines()
+    assert lines and lines[-1] == "OK", result.stdout
+    return lines
+
+
+@pytest.mark.parametrize("scenario", (
+        "torn-write",
+        "crc-mismatch",
+        "compaction-power-loss",
+))
+def test_preference_log_power_loss(harness_binary, tmp_path, scenario):
+    run_harness(harness_binary, scenario, tmp_path / "preferences.bin")
+
+
+def test_preference_log_benchmark(harness_binary, tmp_path):
+    lines = run_harness(harness_binary, "benchmark", tmp_path / "preferences.bin", 100, 2000)
+    results = dict(line.split(" ", 1) for line in lines[:-1])
+
+    assert int(results["preferences"]) == 100
+    assert int(results["saves"]) == 2000
+    for key in ("compactions", "save_per_second", "save_words_per_second", "load_us", "restore_us",
+                "restore_us_per_preference"):
+        assert float(results[key]) >= 0